@@ -0,0 +1,153 @@
+#include "actuator.h"
+
+#include <algorithm>
+
+namespace hvac {
+
+bool NullActuatorBackend::send(const LouverCommand &) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MockActuatorBackend::send(const LouverCommand &command) {
+    std::lock_guard<std::mutex> lock(mutex);
+    sent.push_back(command);
+    return true;
+}
+
+std::vector<LouverCommand> MockActuatorBackend::commands() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sent;
+}
+
+std::size_t MockActuatorBackend::commandCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sent.size();
+}
+
+ActuatorChannel::ActuatorChannel(std::unique_ptr<ActuatorBackend> backend, std::size_t zoneCount,
+                                 double maxCommandsPerSecond)
+    : transport(std::move(backend)),
+      minInterval(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / std::max(maxCommandsPerSecond, 1e-3)))),
+      targets(zoneCount) {
+    worker = std::thread(&ActuatorChannel::run, this);
+}
+
+ActuatorChannel::~ActuatorChannel() {
+    stop();
+}
+
+void ActuatorChannel::markPending(ZoneTarget &target) {
+    if (!target.pending) {
+        target.pending = true;
+        ++pendingCount;
+        wake.notify_one();
+    }
+}
+
+void ActuatorChannel::setPan(ZoneStore::ZoneId zone, int pan) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (zone >= targets.size()) {
+        return;
+    }
+    targets[zone].pan = static_cast<std::int16_t>(pan);
+    markPending(targets[zone]);
+}
+
+void ActuatorChannel::setTilt(ZoneStore::ZoneId zone, int tilt) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (zone >= targets.size()) {
+        return;
+    }
+    targets[zone].tilt = static_cast<std::int16_t>(tilt);
+    markPending(targets[zone]);
+}
+
+void ActuatorChannel::setLouver(ZoneStore::ZoneId zone, int pan, int tilt) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (zone >= targets.size()) {
+        return;
+    }
+    targets[zone].pan = static_cast<std::int16_t>(pan);
+    targets[zone].tilt = static_cast<std::int16_t>(tilt);
+    markPending(targets[zone]);
+}
+
+void ActuatorChannel::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this]() { return (pendingCount == 0 && inFlight == 0) || stopping; });
+}
+
+void ActuatorChannel::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    drained.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::uint64_t ActuatorChannel::sentCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sent;
+}
+
+void ActuatorChannel::run() {
+    std::vector<LouverCommand> ready;
+    ready.reserve(targets.size());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (pendingCount == 0) {
+            wake.wait(lock, [this]() { return pendingCount > 0 || stopping; });
+            continue;
+        }
+
+        // Забираем зоны, которым уже можно слать, и ищем ближайший момент для остальных
+        const Clock::time_point now = Clock::now();
+        Clock::time_point earliest = Clock::time_point::max();
+        ready.clear();
+        for (std::size_t zone = 0; zone < targets.size(); ++zone) {
+            ZoneTarget &target = targets[zone];
+            if (!target.pending) {
+                continue;
+            }
+            if (target.nextAllowed <= now) {
+                target.pending = false;
+                --pendingCount;
+                target.nextAllowed = now + minInterval;
+                LouverCommand command;
+                command.zone = static_cast<ZoneStore::ZoneId>(zone);
+                command.pan = target.pan;
+                command.tilt = target.tilt;
+                command.sequence = ++target.sequence;
+                ready.push_back(command);
+            } else {
+                earliest = std::min(earliest, target.nextAllowed);
+            }
+        }
+
+        if (!ready.empty()) {
+            // Отправка идёт без блокировки, чтобы слайдеры не ждали шину
+            inFlight = ready.size();
+            lock.unlock();
+            for (const LouverCommand &command : ready) {
+                transport->send(command);
+            }
+            lock.lock();
+            sent += ready.size();
+            inFlight = 0;
+            if (pendingCount == 0) {
+                drained.notify_all();
+            }
+            continue;
+        }
+        wake.wait_until(lock, earliest);
+    }
+}
+
+} // namespace hvac
@@ -0,0 +1,127 @@
+#ifndef ACTUATOR_H
+#define ACTUATOR_H
+
+#include "zonestore.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Команда приводу жалюзи зоны: горизонтальный и вертикальный углы.
+ */
+struct LouverCommand {
+    ZoneStore::ZoneId zone = 0;
+    std::int16_t pan = 0;       // Горизонтальный угол, градусы
+    std::int16_t tilt = 0;      // Вертикальный угол, градусы
+    std::uint64_t sequence = 0; // Порядковый номер команды для зоны
+};
+
+/**
+ * @class ActuatorBackend
+ * @brief Транспорт команд к приводам (шина жалюзи). Вызывается из потока канала.
+ */
+class ActuatorBackend {
+public:
+    virtual ~ActuatorBackend() = default;
+    virtual bool send(const LouverCommand &command) = 0;
+};
+
+/**
+ * @class NullActuatorBackend
+ * @brief Шина без подключённых приводов: команды принимаются и только считаются.
+ *
+ * Для окна, пока реальной шины нет; память не растёт со временем работы.
+ */
+class NullActuatorBackend : public ActuatorBackend {
+public:
+    bool send(const LouverCommand &command) override;
+
+    std::uint64_t commandCount() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> count{0};
+};
+
+/**
+ * @class MockActuatorBackend
+ * @brief Замена шины для проверок: запоминает все отправленные команды.
+ */
+class MockActuatorBackend : public ActuatorBackend {
+public:
+    bool send(const LouverCommand &command) override;
+
+    std::vector<LouverCommand> commands() const; // Копия отправленных команд
+    std::size_t commandCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<LouverCommand> sent;
+};
+
+/**
+ * @class ActuatorChannel
+ * @brief Канал команд жалюзи с ограничением частоты и свёрткой промежуточных положений.
+ *
+ * Слайдеры лишь обновляют желаемое положение зоны. Фоновый поток отправляет
+ * в backend не больше maxCommandsPerSecond команд на зону, причём каждая
+ * команда несёт последнее желаемое положение; после остановки перетаскивания
+ * итоговое положение отправляется гарантированно.
+ */
+class ActuatorChannel {
+public:
+    ActuatorChannel(std::unique_ptr<ActuatorBackend> backend, std::size_t zoneCount,
+                    double maxCommandsPerSecond);
+    ~ActuatorChannel();
+
+    ActuatorChannel(const ActuatorChannel &) = delete;
+    ActuatorChannel &operator=(const ActuatorChannel &) = delete;
+
+    void setPan(ZoneStore::ZoneId zone, int pan);
+    void setTilt(ZoneStore::ZoneId zone, int tilt);
+    void setLouver(ZoneStore::ZoneId zone, int pan, int tilt);
+
+    void flush(); // Ждёт отправки всех желаемых положений
+    void stop();
+
+    ActuatorBackend &backend() { return *transport; }
+    std::uint64_t sentCount() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct ZoneTarget {
+        std::int16_t pan = 0;
+        std::int16_t tilt = 0;
+        bool pending = false;             // Желаемое положение ещё не отправлено
+        std::uint64_t sequence = 0;
+        Clock::time_point nextAllowed{};  // Раньше этого момента зоне слать нельзя
+    };
+
+    void markPending(ZoneTarget &target);
+    void run();
+
+    std::unique_ptr<ActuatorBackend> transport;
+    Clock::duration minInterval;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;      // Новые желаемые положения или остановка
+    std::condition_variable drained;   // Все положения отправлены
+    std::vector<ZoneTarget> targets;
+    std::size_t pendingCount = 0;
+    std::size_t inFlight = 0;
+    std::uint64_t sent = 0;
+    bool stopping = false;
+    std::thread worker;
+};
+
+} // namespace hvac
+
+#endif // ACTUATOR_H
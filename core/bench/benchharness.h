@@ -0,0 +1,110 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file benchharness.h
+ * @brief Минимальный каркас замеров в духе Google Benchmark без внешних зависимостей.
+ *
+ * Каждый замер крутит цикл while (state.keepRunning()), пока не наберётся
+ * минимальное время, и печатает задержку одной итерации и пропускную способность.
+ */
+namespace bench {
+
+class State {
+public:
+    explicit State(std::chrono::nanoseconds minTime) : minTime(minTime) {}
+
+    bool keepRunning() {
+        if (iterations == 0) {
+            start = Clock::now();
+        }
+        // Проверяем часы раз в batch итераций, чтобы не мерить сам таймер
+        if ((iterations & (kCheckEvery - 1)) == 0 && iterations != 0) {
+            elapsedTime = Clock::now() - start;
+            if (elapsedTime >= minTime) {
+                return false;
+            }
+        }
+        ++iterations;
+        return true;
+    }
+
+    void setItemsPerIteration(std::uint64_t items) { itemsPerIteration = items; }
+
+    std::uint64_t iterationCount() const { return iterations; }
+    std::uint64_t items() const { return itemsPerIteration; }
+    std::chrono::nanoseconds elapsed() const { return elapsedTime; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::uint64_t kCheckEvery = 64;
+
+    std::chrono::nanoseconds minTime;
+    std::chrono::nanoseconds elapsedTime{0};
+    Clock::time_point start;
+    std::uint64_t iterations = 0;
+    std::uint64_t itemsPerIteration = 1;
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(State &)> body;
+};
+
+inline std::vector<Benchmark> &registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const char *name, std::function<void(State &)> body) {
+        registry().push_back({name, std::move(body)});
+    }
+};
+
+// Не даёт компилятору выбросить вычисленное значение
+template <typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Запуск: hvac_bench [фильтр подстроки имени] [минимальное время, мс]
+inline int runAll(int argc, char *argv[]) {
+    const char *filter = argc > 1 ? argv[1] : "";
+    const long minMs = argc > 2 ? std::atol(argv[2]) : 200;
+
+    std::printf("%-40s %14s %14s %16s\n", "Benchmark", "Time/iter", "Iterations", "Items/s");
+    for (const Benchmark &benchmark : registry()) {
+        if (std::strstr(benchmark.name.c_str(), filter) == nullptr) {
+            continue;
+        }
+        State state{std::chrono::milliseconds(minMs)};
+        benchmark.body(state);
+
+        const double ns = static_cast<double>(state.elapsed().count());
+        const double iterations = static_cast<double>(state.iterationCount());
+        const double perIteration = iterations > 0 ? ns / iterations : 0;
+        const double itemsPerSecond = ns > 0 ? iterations * state.items() * 1e9 / ns : 0;
+        std::printf("%-40s %11.1f ns %14llu %16.4g\n", benchmark.name.c_str(), perIteration,
+                    static_cast<unsigned long long>(state.iterationCount()), itemsPerSecond);
+    }
+    return 0;
+}
+
+} // namespace bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(function) \
+    static ::bench::Registrar BENCH_CONCAT(benchRegistrar_, __LINE__)(#function, function)
+
+#endif // BENCHHARNESS_H
@@ -0,0 +1,440 @@
+#include "actuator.h"
+#include "benchharness.h"
+#include "controlserver.h"
+#include "historyring.h"
+#include "hvaccontroller.h"
+#include "inputvalidation.h"
+#include "instrumentation.h"
+#include "parametersweep.h"
+#include "readoutformatter.h"
+#include "scheduleengine.h"
+#include "sensoringestion.h"
+#include "sessionprofile.h"
+#include "telemetry.h"
+#include "thermalsim.h"
+#include "units.h"
+#include "zonestore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Одно обновление показаний, как из SettingsDialog::valuesUpdated
+static void BM_ControllerUpdate(bench::State &state) {
+    hvac::ZoneStore store;
+    hvac::Controller controller(store);
+    double t = 20.0;
+    while (state.keepRunning()) {
+        controller.update(t, 45, 101325.0);
+        t += 0.001;
+        bench::doNotOptimize(controller);
+    }
+}
+BENCHMARK(BM_ControllerUpdate);
+
+// Чтение выбранной зоны в других единицах отображения
+static void BM_ControllerDisplayUnits(bench::State &state) {
+    hvac::ZoneStore store;
+    hvac::Controller controller(store);
+    controller.update(21.5, 40, 101325.0);
+    controller.setTemperatureUnit(hvac::TemperatureUnit::Fahrenheit);
+    controller.setPressureUnit(hvac::PressureUnit::MmHg);
+    while (state.keepRunning()) {
+        double temperature = controller.temperature();
+        double pressure = controller.pressure();
+        bench::doNotOptimize(temperature);
+        bench::doNotOptimize(pressure);
+    }
+}
+BENCHMARK(BM_ControllerDisplayUnits);
+
+namespace {
+constexpr std::size_t kZoneCount = 100000;
+
+std::vector<double> filled(std::size_t count, double first, double step) {
+    std::vector<double> values(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = first + step * static_cast<double>(i % 100);
+    }
+    return values;
+}
+
+std::vector<hvac::ZoneStore::ZoneId> shuffledIds(std::size_t count) {
+    std::vector<hvac::ZoneStore::ZoneId> ids(count);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+    return ids;
+}
+}
+
+// Пакетное обновление показаний всех зон непрерывным диапазоном
+static void BM_ZoneStoreUpdateRange100k(bench::State &state) {
+    hvac::ZoneStore store(kZoneCount);
+    const std::vector<double> temperature = filled(kZoneCount, 18.0, 0.05);
+    const std::vector<double> humidity = filled(kZoneCount, 30.0, 0.2);
+    const std::vector<double> pressure = filled(kZoneCount, 101000.0, 5.0);
+    state.setItemsPerIteration(kZoneCount);
+    while (state.keepRunning()) {
+        store.updateReadingsRange(0, kZoneCount, temperature.data(), humidity.data(), pressure.data());
+        bench::doNotOptimize(store);
+    }
+}
+BENCHMARK(BM_ZoneStoreUpdateRange100k);
+
+// Пакетное обновление зон в случайном порядке (показания приходят от разных датчиков)
+static void BM_ZoneStoreUpdateScatter100k(bench::State &state) {
+    hvac::ZoneStore store(kZoneCount);
+    const std::vector<hvac::ZoneStore::ZoneId> ids = shuffledIds(kZoneCount);
+    const std::vector<double> temperature = filled(kZoneCount, 18.0, 0.05);
+    const std::vector<double> humidity = filled(kZoneCount, 30.0, 0.2);
+    const std::vector<double> pressure = filled(kZoneCount, 101000.0, 5.0);
+    state.setItemsPerIteration(kZoneCount);
+    while (state.keepRunning()) {
+        store.updateReadings(ids.data(), kZoneCount, temperature.data(), humidity.data(), pressure.data());
+        bench::doNotOptimize(store);
+    }
+}
+BENCHMARK(BM_ZoneStoreUpdateScatter100k);
+
+// Пакетный запрос: зоны, отклонившиеся от уставки
+static void BM_ZoneStoreFindDeviating100k(bench::State &state) {
+    hvac::ZoneStore store(kZoneCount);
+    const std::vector<double> temperature = filled(kZoneCount, 18.0, 0.05);
+    const std::vector<double> humidity = filled(kZoneCount, 30.0, 0.2);
+    const std::vector<double> pressure = filled(kZoneCount, 101000.0, 5.0);
+    store.updateReadingsRange(0, kZoneCount, temperature.data(), humidity.data(), pressure.data());
+    std::vector<hvac::ZoneStore::ZoneId> out(kZoneCount);
+    state.setItemsPerIteration(kZoneCount);
+    while (state.keepRunning()) {
+        std::size_t found = store.findDeviating(1.5, out.data());
+        bench::doNotOptimize(found);
+    }
+}
+BENCHMARK(BM_ZoneStoreFindDeviating100k);
+
+// Пересчёт показаний для дашборда: по одному значению через convertTemperature
+static void BM_ConvertTemperatureScalar4k(bench::State &state) {
+    const std::vector<double> celsius = filled(4096, -20.0, 0.7);
+    std::vector<double> out(celsius.size());
+    state.setItemsPerIteration(celsius.size());
+    while (state.keepRunning()) {
+        for (std::size_t i = 0; i < celsius.size(); ++i) {
+            out[i] = hvac::convertTemperature(celsius[i], hvac::TemperatureUnit::Celsius,
+                                              hvac::TemperatureUnit::Fahrenheit);
+        }
+        bench::doNotOptimize(out.front());
+    }
+}
+BENCHMARK(BM_ConvertTemperatureScalar4k);
+
+// Тот же пересчёт планом, выбранным один раз для пары единиц
+static void BM_ConvertTemperaturePlan4k(bench::State &state) {
+    const std::vector<double> celsius = filled(4096, -20.0, 0.7);
+    std::vector<double> out(celsius.size());
+    const hvac::ConversionPlan plan =
+        hvac::planConversion(hvac::TemperatureUnit::Celsius, hvac::TemperatureUnit::Fahrenheit);
+    state.setItemsPerIteration(celsius.size());
+    while (state.keepRunning()) {
+        plan.apply(celsius.data(), out.data(), celsius.size());
+        bench::doNotOptimize(out.front());
+    }
+}
+BENCHMARK(BM_ConvertTemperaturePlan4k);
+
+// Пара единиц известна на этапе компиляции
+static void BM_ConvertPressureStatic4k(bench::State &state) {
+    const std::vector<double> pascals = filled(4096, 99000.0, 40.0);
+    std::vector<double> out(pascals.size());
+    state.setItemsPerIteration(pascals.size());
+    while (state.keepRunning()) {
+        hvac::convertPressures<hvac::PressureUnit::Pascal, hvac::PressureUnit::MmHg>(
+            pascals.data(), out.data(), pascals.size());
+        bench::doNotOptimize(out.front());
+    }
+}
+BENCHMARK(BM_ConvertPressureStatic4k);
+
+// Поток показаний: 1024 показания на 256 зон, затем свёртка в пакет
+static void BM_SensorIngestPushDrain1k(bench::State &state) {
+    constexpr std::size_t kSamples = 1024;
+    constexpr std::size_t kZones = 256;
+    hvac::SensorIngestion ingestion(kZones, kSamples);
+    hvac::SensorBatch batch;
+    batch.reserve(kZones);
+    hvac::ZoneStore store(kZones);
+    state.setItemsPerIteration(kSamples);
+    while (state.keepRunning()) {
+        for (std::size_t i = 0; i < kSamples; ++i) {
+            hvac::SensorSample sample;
+            sample.zone = static_cast<hvac::ZoneStore::ZoneId>(i % kZones);
+            sample.temperature = 20.0 + static_cast<double>(i) * 0.01;
+            ingestion.push(sample);
+        }
+        ingestion.drain(batch);
+        batch.applyTo(store);
+        bench::doNotOptimize(store);
+    }
+}
+BENCHMARK(BM_SensorIngestPushDrain1k);
+
+// Метки при частых показаниях: большинство обновлений не меняет видимый текст
+static void BM_ReadoutFormatterUpdate(bench::State &state) {
+    hvac::ReadoutFormatter formatter;
+    formatter.setPrefix(hvac::ReadoutFormatter::Temperature, "Температура: ");
+    formatter.setPrefix(hvac::ReadoutFormatter::Humidity, "Влажность: ");
+    formatter.setPrefix(hvac::ReadoutFormatter::Pressure, "Давление: ");
+    double t = 21.0;
+    while (state.keepRunning()) {
+        formatter.setTemperature(t, hvac::TemperatureUnit::Celsius);
+        formatter.setHumidity(45);
+        formatter.setPressure(101325.0, hvac::PressureUnit::Pascal);
+        for (int field = 0; field < hvac::ReadoutFormatter::FieldCount; ++field) {
+            const auto id = static_cast<hvac::ReadoutFormatter::Field>(field);
+            if (formatter.isDirty(id)) {
+                std::string_view text = formatter.take(id);
+                bench::doNotOptimize(text);
+            }
+        }
+        t += 0.001;
+    }
+}
+BENCHMARK(BM_ReadoutFormatterUpdate);
+
+// Кадр графика: 6 часов показаний с частотой 10 Гц прореживаются до 1000 пикселей
+static void BM_TrendDecimate6h(bench::State &state) {
+    constexpr std::size_t kSamples = 6 * 3600 * 10;
+    constexpr std::size_t kPixels = 1000;
+    hvac::HistoryRing history(kSamples);
+    for (std::size_t i = 0; i < kSamples + 1234; ++i) {
+        history.push(22.0 + 3.0 * std::sin(static_cast<double>(i) * 1e-3));
+    }
+    std::vector<hvac::TrendPoint> points(2 * kPixels);
+    state.setItemsPerIteration(kSamples);
+    while (state.keepRunning()) {
+        double low, high;
+        std::size_t count = hvac::decimateMinMax(history, kPixels, points.data(), low, high);
+        bench::doNotOptimize(count);
+    }
+}
+BENCHMARK(BM_TrendDecimate6h);
+
+// Кадр графика с инкрементальными корзинами: новое значение в заполненной 6-часовой истории и сборка точек
+static void BM_TrendIncremental6h(bench::State &state) {
+    constexpr std::size_t kSamples = 6 * 3600 * 10;
+    constexpr std::size_t kPixels = 1000;
+    hvac::HistoryRing history(kSamples);
+    for (std::size_t i = 0; i < kSamples + 1234; ++i) {
+        history.push(22.0 + 3.0 * std::sin(static_cast<double>(i) * 1e-3));
+    }
+    hvac::MinMaxBuckets buckets;
+    buckets.reset(history, kPixels);
+    std::vector<hvac::TrendPoint> points(2 * kPixels);
+    double t = 0;
+    while (state.keepRunning()) {
+        history.push(22.0 + 3.0 * std::sin(t));
+        buckets.push(history);
+        double low, high;
+        std::size_t count = buckets.points(points.data(), low, high);
+        bench::doNotOptimize(count);
+        t += 1e-3;
+    }
+}
+BENCHMARK(BM_TrendIncremental6h);
+
+// Один шаг моделирования 1000 зон с включёнными кондиционерами
+static void BM_SimulationStep1kZones(bench::State &state) {
+    constexpr std::size_t kZones = 1000;
+    hvac::ZoneStore store(kZones);
+    std::vector<hvac::ZoneStore::ZoneId> ids(kZones);
+    std::iota(ids.begin(), ids.end(), 0);
+    const std::vector<double> setpoints = filled(kZones, 20.0, 0.05);
+    const std::vector<double> humidity = filled(kZones, 40.0, 0.1);
+    store.setSetpoints(ids.data(), kZones, setpoints.data(), humidity.data());
+    store.setACStatus(ids.data(), kZones, true);
+    hvac::SimulationEngine engine(store);
+    state.setItemsPerIteration(kZones);
+    while (state.keepRunning()) {
+        engine.step();
+        bench::doNotOptimize(store);
+    }
+}
+BENCHMARK(BM_SimulationStep1kZones);
+
+// Постановка события в очередь журнала с горячего пути GUI
+static void BM_TelemetryLogLouver(bench::State &state) {
+    hvac::TelemetryWriter writer("hvac_bench_telemetry.bin");
+    int angle = 0;
+    while (state.keepRunning()) {
+        writer.logLouver(0, angle, 45);
+        angle = (angle + 1) % 181;
+    }
+    writer.close();
+    std::remove("hvac_bench_telemetry.bin");
+}
+BENCHMARK(BM_TelemetryLogLouver);
+
+// Проигрывание отображённого в память журнала (1 млн записей) в хранилище зон
+static void BM_TelemetryReplay1M(bench::State &state) {
+    constexpr std::size_t kEvents = 1000000;
+    constexpr std::size_t kZones = 100;
+    const char *path = "hvac_bench_replay.bin";
+    std::remove(path); // Писатель дописывает существующий журнал
+    {
+        hvac::TelemetryWriter writer(path, kEvents);
+        hvac::TelemetryEvent event;
+        event.timestampMs = hvac::telemetryNowMs();
+        for (std::size_t i = 0; i < kEvents; ++i) {
+            event.zone = static_cast<hvac::ZoneStore::ZoneId>(i % kZones);
+            event.timestampMs += 10;
+            event.values[0] = 20.0 + static_cast<double>(i % 500) * 0.01;
+            event.values[1] = 40.0 + static_cast<double>(i % 300) * 0.01;
+            event.values[2] = 101325.0 + static_cast<double>(i % 700) * 0.1;
+            writer.log(event);
+        }
+    }
+    hvac::TelemetryReader reader;
+    reader.open(path);
+    hvac::ZoneStore store(kZones);
+    state.setItemsPerIteration(reader.recordCount());
+    while (state.keepRunning()) {
+        std::size_t applied = hvac::replayTelemetry(reader, store);
+        bench::doNotOptimize(applied);
+    }
+    reader.close();
+    std::remove(path);
+}
+BENCHMARK(BM_TelemetryReplay1M);
+
+// Тик слайдера: обновление желаемого положения жалюзи (отправка идёт в фоне)
+static void BM_ActuatorSliderTick(bench::State &state) {
+    hvac::ActuatorChannel channel(std::make_unique<hvac::MockActuatorBackend>(), 16, 10.0);
+    int angle = 0;
+    while (state.keepRunning()) {
+        channel.setPan(0, angle);
+        angle = (angle + 1) % 181;
+    }
+    channel.stop();
+}
+BENCHMARK(BM_ActuatorSliderTick);
+
+// Чтение профиля сеанса на старте панели (вместо диалога выбора разрешения)
+static void BM_SessionProfileLoad(bench::State &state) {
+    const char *path = "hvac_bench_profile.bin";
+    hvac::ZoneStore store(16);
+    hvac::SessionProfile saved;
+    saved.captureSetpoints(store);
+    hvac::saveSessionProfile(path, saved);
+    hvac::SessionProfile loaded;
+    while (state.keepRunning()) {
+        bool ok = hvac::loadSessionProfile(path, loaded);
+        bench::doNotOptimize(ok);
+    }
+    std::remove(path);
+}
+BENCHMARK(BM_SessionProfileLoad);
+
+// Опрос состояния зоны через Unix-сокет: запрос, ожидание ответа, следующий запрос
+static void BM_ControlServerPoll(bench::State &state) {
+    const char *path = "hvac_bench_control.sock";
+    hvac::ZoneStore store(16);
+    hvac::ControlServer server;
+    server.listenUnix(path);
+    server.publish(store);
+    hvac::ControlClient client;
+    client.connectUnix(path);
+    hvac::ControlResponse response;
+    while (state.keepRunning()) {
+        bool ok = client.readState(3, response);
+        bench::doNotOptimize(ok);
+    }
+    client.close();
+    server.stop();
+}
+BENCHMARK(BM_ControlServerPoll);
+
+// Цена одного замера: две отметки времени и запись в гистограмму своего потока
+static void BM_ScopedTimer(bench::State &state) {
+    while (state.keepRunning()) {
+        HVAC_SCOPED_TIMER("benchScopedTimer");
+    }
+}
+BENCHMARK(BM_ScopedTimer);
+
+static void BM_MetricsCapture(bench::State &state) {
+    while (state.keepRunning()) {
+        hvac::MetricsSnapshot snapshot = hvac::captureMetrics();
+        bench::doNotOptimize(snapshot);
+    }
+}
+BENCHMARK(BM_MetricsCapture);
+
+// Недельная программа на 100k зон: шаг расписания на час, переключения приходят пакетом
+static void BM_ScheduleAdvance100kZones(bench::State &state) {
+    const std::size_t zoneCount = 100000;
+    hvac::ScheduleEngine schedule(zoneCount);
+    hvac::SetpointProgram program;
+    program.points = {{hvac::kWeekdays, 7 * 3600, hvac::ScheduleMode::Comfort},
+                      {hvac::kWeekdays, 19 * 3600, hvac::ScheduleMode::Setback},
+                      {hvac::kWeekend, 0, hvac::ScheduleMode::Setback}};
+    const hvac::ScheduleEngine::ProgramId office = schedule.addProgram(program);
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < zoneCount; ++zone) {
+        schedule.assignProgram(zone, office);
+    }
+    hvac::ZoneStore store(zoneCount);
+    hvac::SetpointBatch batch;
+    hvac::ScheduleTime now = 0;
+    while (state.keepRunning()) {
+        schedule.advance(now, batch);
+        batch.applyTo(store);
+        now += 3600;
+    }
+}
+BENCHMARK(BM_ScheduleAdvance100kZones);
+
+// Сутки с шагом 5 минут для 4096 вариантов настроек на всех ядрах
+static void BM_ParameterSweep4kDay(bench::State &state) {
+    hvac::WorkStealingPool pool;
+    hvac::SweepEvaluator evaluator(pool);
+    hvac::SweepGrid grid;
+    grid.temperatureSetpoints = {19, 20, 21, 22, 23, 24, 25, 26};
+    grid.humiditySetpoints = {40, 45, 50, 55};
+    grid.acPolicies = {hvac::ACPolicy::AlwaysOn, hvac::ACPolicy::Occupied};
+    grid.louverPans = {0, 30, 60, 90, 120, 150, 180, 90};
+    grid.louverTilts = {0, 15, 30, 45, 60, 75, 90, 30};
+    const std::vector<hvac::LoadProfile> profiles{
+        hvac::syntheticLoadProfile(hvac::ClimateProfile(), 195 * 86400.0, 86400.0)};
+    hvac::SweepReport report;
+    while (state.keepRunning()) {
+        bool ok = evaluator.evaluate(grid, profiles, report);
+        bench::doNotOptimize(ok);
+    }
+}
+BENCHMARK(BM_ParameterSweep4kDay);
+
+// Таблица уставок на 100k строк из памяти: разбор from_chars и пакетная проверка диапазонов
+static void BM_SetpointImportCsv100k(bench::State &state) {
+    const std::size_t rows = 100000;
+    std::string csv = "zone,temperature,humidity\n";
+    char line[64];
+    for (std::size_t i = 0; i < rows; ++i) {
+        std::snprintf(line, sizeof(line), "%zu,%.2f,%.1f\n", i % 4096, 18.0 + (i % 80) * 0.1, 40.0 + (i % 20));
+        csv += line;
+    }
+    hvac::SetpointImporter importer(4096);
+    hvac::SetpointBatch batch;
+    hvac::ImportReport report;
+    while (state.keepRunning()) {
+        bool ok = importer.parseCsv(csv.data(), csv.size(), batch, report);
+        bench::doNotOptimize(ok);
+    }
+}
+BENCHMARK(BM_SetpointImportCsv100k);
+
+int main(int argc, char *argv[]) {
+    std::printf("Conversion kernel: %s\n", hvac::conversionKernelName());
+    return bench::runAll(argc, argv);
+}
@@ -0,0 +1,134 @@
+// Канал команд жалюзи на заглушке шины: ограничение частоты по зоне, свёртка
+// к последнему положению и гарантированная отправка итогового положения
+#include "actuator.h"
+#include "checkharness.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kCommandsPerSecond = 20.0;
+constexpr std::size_t kZones = 4;
+
+// Заглушка, дополнительно запоминающая момент отправки каждой команды
+class TimedBackend : public hvac::MockActuatorBackend {
+public:
+    bool send(const hvac::LouverCommand &command) override {
+        {
+            std::lock_guard<std::mutex> lock(timesMutex);
+            times.push_back(Clock::now());
+        }
+        return MockActuatorBackend::send(command);
+    }
+
+    std::vector<Clock::time_point> sendTimes() const {
+        std::lock_guard<std::mutex> lock(timesMutex);
+        return times;
+    }
+
+private:
+    mutable std::mutex timesMutex;
+    std::vector<Clock::time_point> times;
+};
+
+void checkRateAndCoalescing() {
+    auto owned = std::make_unique<TimedBackend>();
+    TimedBackend &backend = *owned;
+    hvac::ActuatorChannel channel(std::move(owned), kZones, kCommandsPerSecond);
+
+    // Перетаскивание двух слайдеров: положение меняется каждую миллисекунду
+    const Clock::time_point start = Clock::now();
+    int updates = 0;
+    int lastPan[2] = {0, 0};
+    int lastTilt[2] = {0, 0};
+    while (Clock::now() - start < std::chrono::milliseconds(300)) {
+        for (hvac::ZoneStore::ZoneId zone = 0; zone < 2; ++zone) {
+            lastPan[zone] = (updates + static_cast<int>(zone) * 7) % 180 - 90;
+            lastTilt[zone] = (updates / 3) % 90;
+            channel.setLouver(zone, lastPan[zone], lastTilt[zone]);
+        }
+        ++updates;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    channel.flush();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const std::vector<hvac::LouverCommand> commands = backend.commands();
+    const std::vector<Clock::time_point> times = backend.sendTimes();
+    CHECK(commands.size() == times.size());
+    CHECK(channel.sentCount() == commands.size());
+
+    const auto minInterval = std::chrono::duration<double>(1.0 / kCommandsPerSecond);
+    const auto tolerance = std::chrono::milliseconds(5);
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < 2; ++zone) {
+        std::size_t count = 0;
+        std::uint64_t sequence = 0;
+        Clock::time_point previous{};
+        const hvac::LouverCommand *last = nullptr;
+        for (std::size_t i = 0; i < commands.size(); ++i) {
+            if (commands[i].zone != zone) {
+                continue;
+            }
+            // Номера идут подряд, команды зоны не чаще заданной частоты
+            CHECK(commands[i].sequence == sequence + 1);
+            if (count > 0) {
+                CHECK(times[i] - previous + tolerance >= minInterval);
+            }
+            sequence = commands[i].sequence;
+            previous = times[i];
+            last = &commands[i];
+            ++count;
+        }
+        CHECK(count >= 2);
+        CHECK(count <= static_cast<std::size_t>(elapsed * kCommandsPerSecond) + 2);
+        CHECK(count < static_cast<std::size_t>(updates)); // Промежуточные положения свёрнуты
+
+        // Последняя команда несёт итоговое положение слайдера
+        CHECK(last != nullptr);
+        CHECK(last->pan == lastPan[zone]);
+        CHECK(last->tilt == lastTilt[zone]);
+    }
+    for (const hvac::LouverCommand &command : commands) {
+        CHECK(command.zone < 2);
+    }
+}
+
+void checkFinalDelivery() {
+    auto owned = std::make_unique<hvac::MockActuatorBackend>();
+    hvac::MockActuatorBackend &backend = *owned;
+    hvac::ActuatorChannel channel(std::move(owned), kZones, kCommandsPerSecond);
+
+    // Первая команда уходит сразу, вторая ждёт интервала, но не теряется
+    channel.setLouver(3, 10, 20);
+    channel.flush();
+    channel.setPan(3, -45);
+    channel.setTilt(3, 60);
+    channel.flush();
+
+    const std::vector<hvac::LouverCommand> commands = backend.commands();
+    CHECK(commands.size() == 2);
+    CHECK(commands[0].zone == 3 && commands[0].pan == 10 && commands[0].tilt == 20);
+    CHECK(commands[1].zone == 3 && commands[1].pan == -45 && commands[1].tilt == 60);
+    CHECK(commands[1].sequence == 2);
+
+    // Зоны вне диапазона игнорируются
+    channel.setLouver(kZones, 1, 1);
+    channel.flush();
+    CHECK(backend.commandCount() == 2);
+}
+
+} // namespace
+
+int main() {
+    checkRateAndCoalescing();
+    checkFinalDelivery();
+    std::puts("check_actuator: ok");
+    return 0;
+}
@@ -0,0 +1,242 @@
+// Протокол управления по петле: кадры, разорванные между чтениями, неизвестный
+// код, сверхдлинные пакеты и пути, значения вне диапазона и цикл «установить → прочитать»
+#include "checkharness.h"
+#include "controlserver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const char *const kSocketPath = "check_controlserver.sock";
+
+// Сырой сокет: клиент протокола всегда шлёт целые кадры, а здесь нужны обрывки
+int connectRaw(const char *path) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    CHECK(fd >= 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    CHECK(::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0);
+    return fd;
+}
+
+void sendRaw(int fd, const void *data, std::size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        const ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        CHECK(written > 0);
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void receiveRaw(int fd, void *data, std::size_t size) {
+    char *bytes = static_cast<char *>(data);
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, bytes, size, 0);
+        CHECK(received > 0);
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+}
+
+hvac::ControlRequest makeRequest(hvac::ControlOpcode opcode, std::uint16_t sequence, std::uint32_t zone,
+                                 std::int32_t a = 0, std::int32_t b = 0) {
+    hvac::ControlRequest request = {};
+    request.opcode = static_cast<std::uint8_t>(opcode);
+    request.sequence = sequence;
+    request.zone = zone;
+    request.a = a;
+    request.b = b;
+    return request;
+}
+
+hvac::ControlStatus statusOf(const hvac::ControlResponse &response) {
+    return static_cast<hvac::ControlStatus>(response.status);
+}
+
+// Изменение попадает в очередь в конце прохода цикла сервера, то есть чуть позже ответа
+std::size_t applyWithin(hvac::ControlServer &server, hvac::ZoneStore &store, std::size_t expected) {
+    std::size_t applied = 0;
+    for (int attempt = 0; attempt < 500 && applied < expected; ++attempt) {
+        applied += server.applyPending(store);
+        if (applied < expected) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    return applied;
+}
+
+void checkSplitFrames(const hvac::ZoneStore &store) {
+    const int fd = connectRaw(kSocketPath);
+    hvac::ControlRequest requests[2] = {makeRequest(hvac::ControlOpcode::ReadState, 7, 1),
+                                        makeRequest(hvac::ControlOpcode::ZoneCount, 8, 0)};
+    const char *bytes = reinterpret_cast<const char *>(requests);
+    // 5 + 14 + 13 байт: первый кадр приходит в двух чтениях, второй начинается посреди второго
+    const std::size_t parts[] = {5, 14, 13};
+    std::size_t offset = 0;
+    for (std::size_t part : parts) {
+        sendRaw(fd, bytes + offset, part);
+        offset += part;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    CHECK(offset == sizeof(requests));
+
+    hvac::ControlResponse responses[2];
+    receiveRaw(fd, responses, sizeof(responses));
+    CHECK(responses[0].sequence == 7 && statusOf(responses[0]) == hvac::ControlStatus::Ok);
+    CHECK(responses[0].zone == 1);
+    CHECK(responses[0].temperature == 2150); // Сотые °C из снимка
+    CHECK(responses[1].sequence == 8 && responses[1].zone == store.size());
+
+    // Обрывок кадра без продолжения остаётся без ответа и не ломает следующий
+    sendRaw(fd, bytes, 9);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sendRaw(fd, bytes + 9, sizeof(hvac::ControlRequest) - 9);
+    receiveRaw(fd, responses, sizeof(hvac::ControlResponse));
+    CHECK(responses[0].sequence == 7 && responses[0].temperature == 2150);
+    ::close(fd);
+}
+
+void checkUnknownAndInvalid(hvac::ControlClient &client) {
+    hvac::ControlRequest requests[5] = {
+        makeRequest(static_cast<hvac::ControlOpcode>(0), 1, 0),
+        makeRequest(static_cast<hvac::ControlOpcode>(200), 2, 0),
+        makeRequest(hvac::ControlOpcode::ReadState, 3, 1000),             // Нет такой зоны
+        makeRequest(hvac::ControlOpcode::SetSetpoint, 4, 0, 50000, 4500), // 500 °C
+        makeRequest(hvac::ControlOpcode::SetAC, 5, 0, 7),                 // Нет такого действия
+    };
+    hvac::ControlResponse responses[5];
+    CHECK(client.call(requests, 5, responses));
+    CHECK(statusOf(responses[0]) == hvac::ControlStatus::UnknownOpcode && responses[0].sequence == 1);
+    CHECK(statusOf(responses[1]) == hvac::ControlStatus::UnknownOpcode && responses[1].opcode == 200);
+    CHECK(statusOf(responses[2]) == hvac::ControlStatus::BadZone);
+    CHECK(statusOf(responses[3]) == hvac::ControlStatus::BadValue);
+    CHECK(statusOf(responses[4]) == hvac::ControlStatus::BadValue);
+    // Соединение после отказов живо
+    hvac::ControlResponse response;
+    CHECK(client.readState(0, response) && statusOf(response) == hvac::ControlStatus::Ok);
+}
+
+void checkOversize(hvac::ControlServer &server) {
+    // Кадры фиксированной длины: сверхдлинным бывает пакет (больше одного чтения сервера)
+    // и путь сокета (длиннее sun_path)
+    hvac::ControlServer other;
+    CHECK(!other.listenUnix(std::string(200, 's')));
+
+    constexpr std::size_t kRequests = 20000; // 320 КБ запросов при чтении по 64 КБ
+    std::vector<hvac::ControlRequest> requests(kRequests);
+    for (std::size_t i = 0; i < kRequests; ++i) {
+        requests[i] = makeRequest(hvac::ControlOpcode::ReadState, static_cast<std::uint16_t>(i), i % 3);
+    }
+    const std::uint64_t before = server.requestCount();
+    const int fd = connectRaw(kSocketPath);
+    sendRaw(fd, requests.data(), requests.size() * sizeof(hvac::ControlRequest));
+    std::vector<hvac::ControlResponse> responses(kRequests);
+    receiveRaw(fd, responses.data(), responses.size() * sizeof(hvac::ControlResponse));
+    ::close(fd);
+    for (std::size_t i = 0; i < kRequests; ++i) {
+        CHECK(responses[i].sequence == static_cast<std::uint16_t>(i)); // Порядок ответов сохранён
+        CHECK(responses[i].zone == i % 3 && statusOf(responses[i]) == hvac::ControlStatus::Ok);
+    }
+    CHECK(server.requestCount() - before == kRequests);
+}
+
+void checkHalfClose() {
+    // Клиент пишет весь пакет и закрывает запись, не читая: ответов больше буфера сокета,
+    // и все они должны дойти
+    constexpr std::size_t kRequests = 20000;
+    std::vector<hvac::ControlRequest> requests(kRequests);
+    for (std::size_t i = 0; i < kRequests; ++i) {
+        requests[i] = makeRequest(hvac::ControlOpcode::ReadState, static_cast<std::uint16_t>(i), 1);
+    }
+    const int fd = connectRaw(kSocketPath);
+    sendRaw(fd, requests.data(), requests.size() * sizeof(hvac::ControlRequest));
+    CHECK(::shutdown(fd, SHUT_WR) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::vector<hvac::ControlResponse> responses(kRequests);
+    receiveRaw(fd, responses.data(), responses.size() * sizeof(hvac::ControlResponse));
+    CHECK(responses.back().sequence == static_cast<std::uint16_t>(kRequests - 1));
+    CHECK(responses.back().temperature == 2150);
+    // Затем сервер закрывает соединение
+    char extra;
+    CHECK(::recv(fd, &extra, 1, 0) == 0);
+    ::close(fd);
+}
+
+void checkSocketPathSafety() {
+    // По пути обычный файл: сервер не удаляет его и не слушает
+    const char *path = "check_controlserver.txt";
+    std::FILE *file = std::fopen(path, "w");
+    CHECK(file != nullptr);
+    std::fputs("keep me\n", file);
+    std::fclose(file);
+    hvac::ControlServer other;
+    CHECK(!other.listenUnix(path));
+    file = std::fopen(path, "r");
+    CHECK(file != nullptr);
+    std::fclose(file);
+    std::remove(path);
+}
+
+void checkSetThenGet(hvac::ControlServer &server, hvac::ControlClient &client, hvac::ZoneStore &store) {
+    hvac::ControlResponse response;
+    CHECK(client.setSetpoint(2, 23.5, 47.25, response));
+    CHECK(statusOf(response) == hvac::ControlStatus::Ok);
+    CHECK(client.setAC(2, hvac::ControlACAction::Toggle, response));
+    CHECK(client.setLouver(2, 120, 35, response));
+    CHECK(applyWithin(server, store, 3) == 3);
+    server.publish(store);
+
+    CHECK(client.readState(2, response));
+    CHECK(response.setpointTemperature == 2350 && response.setpointHumidity == 4725);
+    CHECK(response.acOn == 1);
+    CHECK(response.louverPan == 120 && response.louverTilt == 35);
+    // Соседние зоны не задеты
+    CHECK(client.readState(1, response) && response.acOn == 0 && response.louverPan == 0);
+}
+
+} // namespace
+
+int main() {
+    hvac::ZoneStore store(3);
+    store.setReading(1, 21.5, 40.0, 101325.0);
+    hvac::ControlServer server;
+    CHECK(server.listenUnix(kSocketPath));
+    server.publish(store);
+
+    hvac::ControlClient client;
+    CHECK(client.connectUnix(kSocketPath));
+    checkSplitFrames(store);
+    checkUnknownAndInvalid(client);
+    checkOversize(server);
+    checkHalfClose();
+    checkSocketPathSafety();
+    checkSetThenGet(server, client, store);
+
+    client.close();
+    server.stop();
+    std::puts("check_controlserver: ok");
+    return 0;
+}
+
+#else
+
+int main() {
+    std::puts("check_controlserver: skipped (server is Linux-only)");
+    return 0;
+}
+
+#endif
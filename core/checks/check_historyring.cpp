@@ -0,0 +1,166 @@
+// Прореживание истории: MinMaxBuckets после переполнения кольца, вытеснения
+// и слияния корзин совпадает с прямым пересчётом и согласовано с decimateMinMax
+#include "checkharness.h"
+#include "historyring.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Прямой пересчёт min/max по корзинам ширины width, выровненным по абсолютному номеру значения
+std::vector<hvac::TrendPoint> alignedReference(const hvac::HistoryRing &history, std::uint64_t oldest,
+                                               std::uint64_t width) {
+    std::vector<hvac::TrendPoint> points;
+    std::size_t begin = 0;
+    while (begin < history.size()) {
+        const std::uint64_t number = (oldest + begin) / width;
+        std::size_t end = begin;
+        std::size_t minIndex = begin;
+        std::size_t maxIndex = begin;
+        for (; end < history.size() && (oldest + end) / width == number; ++end) {
+            if (history.at(end) < history.at(minIndex)) {
+                minIndex = end;
+            }
+            if (history.at(end) > history.at(maxIndex)) {
+                maxIndex = end;
+            }
+        }
+        const std::size_t first = minIndex < maxIndex ? minIndex : maxIndex;
+        const std::size_t second = minIndex < maxIndex ? maxIndex : minIndex;
+        points.push_back({static_cast<double>(first), history.at(first)});
+        if (second != first) {
+            points.push_back({static_cast<double>(second), history.at(second)});
+        }
+        begin = end;
+    }
+    return points;
+}
+
+bool samePoints(const std::vector<hvac::TrendPoint> &expected, const hvac::TrendPoint *actual, std::size_t count) {
+    if (expected.size() != count) {
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (expected[i].index != actual[i].index || expected[i].value != actual[i].value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool containsIndex(const hvac::TrendPoint *points, std::size_t count, std::size_t index) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (points[i].index == static_cast<double>(index)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Сверяет инкрементальное прореживание с прямым пересчётом и с decimateMinMax
+void verify(const hvac::HistoryRing &history, const hvac::MinMaxBuckets &incremental, std::uint64_t oldest) {
+    const std::size_t buckets = incremental.buckets();
+    std::vector<hvac::TrendPoint> points(2 * buckets);
+    double minValue = 0;
+    double maxValue = 0;
+    const std::size_t count = incremental.points(points.data(), minValue, maxValue);
+
+    std::vector<hvac::TrendPoint> decimated(2 * buckets);
+    double decimatedMin = 0;
+    double decimatedMax = 0;
+    const std::size_t decimatedCount =
+        hvac::decimateMinMax(history, buckets, decimated.data(), decimatedMin, decimatedMax);
+    CHECK(decimatedCount <= 2 * buckets);
+    CHECK(count <= 2 * buckets);
+    if (history.size() == 0) {
+        CHECK(count == 0 && decimatedCount == 0);
+        return;
+    }
+
+    // Диапазон оси одинаков у обоих способов
+    CHECK(minValue == decimatedMin);
+    CHECK(maxValue == decimatedMax);
+
+    // Результат — точное прореживание для одной из ширин 2^k, при которой корзин не больше заданного
+    bool matched = false;
+    for (std::uint64_t width = 1; !matched && width <= 2 * history.size(); width *= 2) {
+        const std::uint64_t bucketCount = (oldest + history.size() - 1) / width - oldest / width + 1;
+        if (bucketCount <= buckets) {
+            matched = samePoints(alignedReference(history, oldest, width), points.data(), count);
+        }
+    }
+    CHECK(matched);
+
+    // Первые появления глобальных экстремумов есть в обоих рядах
+    std::size_t minIndex = 0;
+    std::size_t maxIndex = 0;
+    for (std::size_t i = 1; i < history.size(); ++i) {
+        if (history.at(i) < history.at(minIndex)) {
+            minIndex = i;
+        }
+        if (history.at(i) > history.at(maxIndex)) {
+            maxIndex = i;
+        }
+    }
+    CHECK(containsIndex(points.data(), count, minIndex) && containsIndex(points.data(), count, maxIndex));
+    CHECK(containsIndex(decimated.data(), decimatedCount, minIndex) &&
+          containsIndex(decimated.data(), decimatedCount, maxIndex));
+    for (std::size_t i = 1; i < count; ++i) {
+        CHECK(points[i].index > points[i - 1].index);
+    }
+}
+
+void checkStream(std::size_t capacity, std::size_t buckets, std::size_t pushes, int pattern) {
+    hvac::HistoryRing history(capacity);
+    hvac::MinMaxBuckets incremental;
+    incremental.reset(history, buckets);
+    std::mt19937 random(static_cast<std::uint32_t>(capacity * 31 + buckets));
+    std::uniform_int_distribution<int> small(0, 5); // Много повторов: проверка выбора первого экстремума
+
+    for (std::size_t n = 0; n < pushes; ++n) {
+        double value = 0;
+        switch (pattern) {
+        case 0:
+            value = small(random);
+            break;
+        case 1:
+            value = static_cast<double>(n); // Максимум всегда новый, минимум всегда вытесняется
+            break;
+        default:
+            value = -static_cast<double>(n % (capacity + 3)); // Пила, сдвинутая относительно кольца
+            break;
+        }
+        history.push(value);
+        incremental.push(history);
+        const std::uint64_t oldest = n + 1 - history.size();
+        verify(history, incremental, oldest);
+    }
+    CHECK(history.size() == std::min(capacity, pushes));
+
+    // Смена числа корзин и очистка пересчитывают всё заново, отсчёт номеров с нуля
+    incremental.reset(history, buckets / 2 + 1);
+    verify(history, incremental, 0);
+    history.clear();
+    incremental.reset(history, buckets);
+    verify(history, incremental, 0);
+    history.push(1.5);
+    incremental.push(history);
+    verify(history, incremental, 0);
+}
+
+} // namespace
+
+int main() {
+    for (int pattern = 0; pattern < 3; ++pattern) {
+        checkStream(1, 1, 20, pattern);
+        checkStream(7, 3, 100, pattern);
+        checkStream(64, 8, 600, pattern);   // Ёмкость кратна ширине корзины
+        checkStream(100, 16, 1500, pattern); // Не кратна: окно задевает лишнюю корзину
+        checkStream(1000, 64, 4000, pattern);
+    }
+    std::puts("check_historyring: ok");
+    return 0;
+}
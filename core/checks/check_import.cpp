@@ -0,0 +1,155 @@
+// Импорт уставок: отчёт об отклонённых строках CSV и записях HVST, порядок
+// ошибок разбора и диапазонов и предел подробностей отчёта
+#include "checkharness.h"
+#include "inputvalidation.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *const kBinaryPath = "check_import.hvst";
+
+bool hasIssue(const hvac::InputIssue &issue, std::size_t row, hvac::InputField field, hvac::InputError error) {
+    return issue.row == row && issue.field == field && issue.error == error;
+}
+
+void checkCsvReport() {
+    const std::string csv = "zone;temperature;humidity\n" // 1: заголовок
+                            "# комментарий\n"             // 2
+                            "0,22.5,45\n"                 // 3
+                            "\n"                          // 4
+                            "1,23\n"                      // 5: не хватает полей
+                            "2,80,45\n"                   // 6: температура вне диапазона
+                            "3,21,45,7\n"                 // 7: лишнее поле
+                            "12,21,45\n"                  // 8: нет такой зоны
+                            "4,abc,45\n"                  // 9: не число
+                            "5,21,101\n"                  // 10: влажность вне диапазона
+                            "6,21.5x,40\n"                // 11: лишние символы
+                            "7; -10.25 ; +30\r\n"          // 12: пробелы, '+', CRLF
+                            "1.5,21,45\n"                 // 13: зона не целая
+                            "8,nan,45";                   // 14: без перевода строки в конце
+    hvac::SetpointImporter importer(10);
+    hvac::SetpointBatch batch;
+    hvac::ImportReport report;
+    CHECK(importer.parseCsv(csv.data(), csv.size(), batch, report));
+
+    CHECK(report.rows == 11);
+    CHECK(report.accepted == 2 && batch.size() == 2);
+    CHECK(report.rejected == 9 && report.issues.size() == 9);
+    CHECK(batch.zones[0] == 0 && batch.temperature[0] == 22.5 && batch.humidity[0] == 45);
+    CHECK(batch.zones[1] == 7 && batch.temperature[1] == -10.25 && batch.humidity[1] == 30);
+
+    using hvac::InputError;
+    using hvac::InputField;
+    const std::vector<hvac::InputIssue> &issues = report.issues;
+    CHECK(hasIssue(issues[0], 5, InputField::Humidity, InputError::MissingField));
+    CHECK(hasIssue(issues[1], 6, InputField::Temperature, InputError::OutOfRange));
+    CHECK(hasIssue(issues[2], 7, InputField::Humidity, InputError::ExtraField));
+    CHECK(hasIssue(issues[3], 8, InputField::Zone, InputError::BadZone));
+    CHECK(hasIssue(issues[4], 9, InputField::Temperature, InputError::NotANumber));
+    CHECK(hasIssue(issues[5], 10, InputField::Humidity, InputError::OutOfRange));
+    CHECK(hasIssue(issues[6], 11, InputField::Temperature, InputError::TrailingCharacters));
+    CHECK(hasIssue(issues[7], 13, InputField::Zone, InputError::NotAnInteger));
+    CHECK(hasIssue(issues[8], 14, InputField::Temperature, InputError::NotANumber));
+}
+
+void checkReportCapKeepsFirstRows() {
+    // Ошибки диапазонов находятся позже ошибок разбора, но стоят раньше в файле:
+    // в отчёте должны остаться именно первые kMaxReportedIssues строк
+    constexpr std::size_t kRows = 3000;
+    constexpr std::size_t kRangeRows = 600; // До этой строки — ошибки диапазона, дальше — разбора
+    std::string csv;
+    for (std::size_t row = 1; row <= kRows; ++row) {
+        if (row % 4 == 0) {
+            csv += "1,21,45\n";
+        } else if (row <= kRangeRows) {
+            csv += "1,500,45\n"; // Вне диапазона (второй проход)
+        } else {
+            csv += "1,x,45\n"; // Не число (при разборе)
+        }
+    }
+    hvac::SetpointImporter importer(2);
+    hvac::SetpointBatch batch;
+    hvac::ImportReport report;
+    CHECK(importer.parseCsv(csv.data(), csv.size(), batch, report));
+
+    const std::size_t bad = kRows - kRows / 4;
+    CHECK(report.rows == kRows);
+    CHECK(report.accepted == kRows / 4);
+    CHECK(report.rejected == bad);
+    CHECK(report.issues.size() == hvac::ImportReport::kMaxReportedIssues);
+    std::size_t expectedRow = 0;
+    for (const hvac::InputIssue &issue : report.issues) {
+        ++expectedRow;
+        if (expectedRow % 4 == 0) {
+            ++expectedRow;
+        }
+        CHECK(issue.row == expectedRow);
+        const bool rangePass = issue.row <= kRangeRows;
+        CHECK(issue.error == (rangePass ? hvac::InputError::OutOfRange : hvac::InputError::NotANumber));
+    }
+    // В пределе оказались оба вида ошибок
+    CHECK(report.issues.front().error == hvac::InputError::OutOfRange);
+    CHECK(report.issues.back().error == hvac::InputError::NotANumber);
+
+    // Отчёт и буферы переиспользуются: повторный разбор даёт тот же итог
+    hvac::ImportReport again;
+    CHECK(importer.parseCsv(csv.data(), csv.size(), batch, again));
+    CHECK(again.rejected == report.rejected && again.issues.size() == report.issues.size());
+    CHECK(again.issues.front().row == 1 && again.issues.back().row == report.issues.back().row);
+}
+
+void checkBinaryReport() {
+    hvac::SetpointBatch source;
+    const double temperature[] = {22.0, 90.0, 21.0, 20.0, NAN, 19.5};
+    const double humidity[] = {45.0, 45.0, -1.0, 50.0, 40.0, 55.0};
+    const hvac::ZoneStore::ZoneId zones[] = {0, 1, 2, 40, 3, 4};
+    for (std::size_t i = 0; i < 6; ++i) {
+        source.zones.push_back(zones[i]);
+        source.temperature.push_back(temperature[i]);
+        source.humidity.push_back(humidity[i]);
+    }
+    CHECK(hvac::saveSetpointBinary(kBinaryPath, source));
+
+    hvac::SetpointImporter importer(8);
+    hvac::SetpointBatch batch;
+    hvac::ImportReport report;
+    CHECK(importer.importFile(kBinaryPath, batch, report)); // Формат по сигнатуре
+    CHECK(report.rows == 6 && report.accepted == 2 && report.rejected == 4);
+    CHECK(batch.zones[0] == 0 && batch.zones[1] == 4);
+    CHECK_NEAR(batch.temperature[1], 19.5, 1e-6);
+    using hvac::InputError;
+    using hvac::InputField;
+    CHECK(report.issues.size() == 4);
+    CHECK(hasIssue(report.issues[0], 2, InputField::Temperature, InputError::OutOfRange));
+    CHECK(hasIssue(report.issues[1], 3, InputField::Humidity, InputError::OutOfRange));
+    CHECK(hasIssue(report.issues[2], 4, InputField::Zone, InputError::BadZone));
+    CHECK(hasIssue(report.issues[3], 5, InputField::Temperature, InputError::NotANumber));
+
+    // Испорченный файл не импортируется вовсе
+    std::FILE *file = std::fopen(kBinaryPath, "rb");
+    CHECK(file != nullptr);
+    std::vector<unsigned char> data(16 + 6 * 12);
+    CHECK(std::fread(data.data(), 1, data.size(), file) == data.size());
+    std::fclose(file);
+    std::vector<unsigned char> damaged = data;
+    damaged[20] ^= 0x40; // Контрольная сумма не сойдётся
+    CHECK(!importer.parseBinary(damaged.data(), damaged.size(), batch, report));
+    CHECK(!importer.parseBinary(data.data(), data.size() - 1, batch, report)); // Обрезан
+    CHECK(importer.parseBinary(data.data(), data.size(), batch, report) && report.accepted == 2);
+    std::remove(kBinaryPath);
+}
+
+} // namespace
+
+int main() {
+    checkCsvReport();
+    checkReportCapKeepsFirstRows();
+    checkBinaryReport();
+    std::puts("check_import: ok");
+    return 0;
+}
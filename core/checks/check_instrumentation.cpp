@@ -0,0 +1,186 @@
+// Гистограмма задержек: границы корзин и квантили на известных распределениях;
+// MetricsDumper::stop() выгружает замеры последнего неполного периода
+#include "checkharness.h"
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Histogram = hvac::LatencyHistogram;
+
+void checkBuckets() {
+    // Малые значения — каждое в своей корзине
+    for (std::uint64_t value = 0; value < Histogram::kSubBuckets; ++value) {
+        CHECK(Histogram::bucketOf(value) == value);
+        CHECK(Histogram::bucketUpperBound(value) == value);
+    }
+
+    // Около каждой степени двойки: значение лежит в своей корзине, погрешность не больше 1/16
+    std::vector<std::uint64_t> values;
+    for (unsigned exponent = Histogram::kSubBucketBits; exponent <= Histogram::kMaxExponent; ++exponent) {
+        const std::uint64_t power = std::uint64_t(1) << exponent;
+        for (std::uint64_t value : {power - 1, power, power + 1, power + power / 3, 2 * power - 1}) {
+            values.push_back(value);
+        }
+    }
+    std::size_t previousBucket = 0;
+    std::uint64_t previousValue = 0;
+    for (std::uint64_t value : values) {
+        const std::size_t bucket = Histogram::bucketOf(value);
+        CHECK(bucket < Histogram::kBucketCount);
+        CHECK(bucket >= previousBucket); // Монотонно по значению
+        CHECK(value >= previousValue);
+        CHECK(Histogram::bucketUpperBound(bucket) >= value);
+        CHECK(Histogram::bucketUpperBound(bucket - 1) < value);
+        CHECK(static_cast<double>(Histogram::bucketUpperBound(bucket) - value) <=
+              static_cast<double>(value) / Histogram::kSubBuckets);
+        previousBucket = bucket;
+        previousValue = value;
+    }
+
+    // Соседние корзины не перекрываются и не оставляют пропусков
+    for (std::size_t bucket = 1; bucket + 1 < Histogram::kBucketCount; ++bucket) {
+        const std::uint64_t upper = Histogram::bucketUpperBound(bucket);
+        CHECK(Histogram::bucketOf(upper) == bucket);
+        CHECK(Histogram::bucketOf(upper + 1) == bucket + 1);
+    }
+
+    // Значения за пределами диапазона — в последней корзине
+    CHECK(Histogram::bucketOf(std::uint64_t(1) << (Histogram::kMaxExponent + 1)) == Histogram::kBucketCount - 1);
+    CHECK(Histogram::bucketOf(UINT64_MAX) == Histogram::kBucketCount - 1);
+}
+
+// Точный квантиль по отсортированной выборке в том же определении ранга, что и percentile()
+std::uint64_t exactPercentile(std::vector<std::uint64_t> sorted, double fraction) {
+    std::sort(sorted.begin(), sorted.end());
+    const std::uint64_t rank =
+        std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * sorted.size())));
+    return sorted[rank - 1];
+}
+
+void checkDistribution(const std::vector<std::uint64_t> &values) {
+    Histogram histogram;
+    std::uint64_t sum = 0;
+    for (std::uint64_t value : values) {
+        histogram.record(value);
+        sum += value;
+    }
+    CHECK(histogram.count() == values.size());
+    CHECK(histogram.totalValue() == sum);
+    for (double fraction : {0.0, 0.001, 0.1, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+        const std::uint64_t exact = exactPercentile(values, fraction);
+        CHECK(histogram.percentile(fraction) == Histogram::bucketUpperBound(Histogram::bucketOf(exact)));
+    }
+}
+
+void checkPercentiles() {
+    Histogram empty;
+    CHECK(empty.percentile(0.5) == 0 && empty.maximum() == 0 && empty.mean() == 0.0);
+
+    // Равномерное 1..1000 нс: p50 — корзина с 500
+    std::vector<std::uint64_t> uniform;
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        uniform.push_back(value);
+    }
+    checkDistribution(uniform);
+    Histogram histogram;
+    for (std::uint64_t value : uniform) {
+        histogram.record(value);
+    }
+    CHECK(histogram.percentile(0.5) >= 500 && histogram.percentile(0.5) <= 500 + 500 / 16);
+    CHECK(histogram.maximum() >= 1000 && histogram.maximum() <= 1000 + 1000 / 16);
+    CHECK_NEAR(histogram.mean(), 500.5, 1e-9);
+    CHECK(histogram.percentile(-1.0) == histogram.percentile(0.0)); // Доля ограничивается [0, 1]
+    CHECK(histogram.percentile(2.0) == histogram.maximum());
+
+    // Два режима: 99% быстрых ответов и 1% медленных
+    Histogram bimodal;
+    for (int i = 0; i < 9900; ++i) {
+        bimodal.record(1000);
+    }
+    for (int i = 0; i < 100; ++i) {
+        bimodal.record(1000000);
+    }
+    const std::uint64_t fast = Histogram::bucketUpperBound(Histogram::bucketOf(1000));
+    const std::uint64_t slow = Histogram::bucketUpperBound(Histogram::bucketOf(1000000));
+    CHECK(bimodal.percentile(0.5) == fast);
+    CHECK(bimodal.percentile(0.99) == fast);
+    CHECK(bimodal.percentile(0.9901) == slow);
+    CHECK(bimodal.percentile(0.999) == slow);
+    CHECK(bimodal.maximum() == slow);
+
+    // Экспоненциальное и логнормальное распределения с длинным хвостом
+    std::mt19937_64 random(12345);
+    std::exponential_distribution<double> exponential(1.0 / 20000.0);
+    std::lognormal_distribution<double> lognormal(10.0, 2.0);
+    std::vector<std::uint64_t> exponentialValues;
+    std::vector<std::uint64_t> lognormalValues;
+    for (int i = 0; i < 50000; ++i) {
+        exponentialValues.push_back(static_cast<std::uint64_t>(exponential(random)));
+        lognormalValues.push_back(static_cast<std::uint64_t>(lognormal(random)));
+    }
+    checkDistribution(exponentialValues);
+    checkDistribution(lognormalValues);
+
+    // Слияние и разность снимков дают ту же гистограмму, что и прямая запись
+    Histogram first;
+    Histogram second;
+    Histogram all;
+    for (std::size_t i = 0; i < exponentialValues.size(); ++i) {
+        (i % 2 == 0 ? first : second).record(exponentialValues[i]);
+        all.record(exponentialValues[i]);
+    }
+    Histogram merged = first;
+    merged.merge(second);
+    merged.subtract(first);
+    for (double fraction : {0.5, 0.99, 1.0}) {
+        CHECK(merged.percentile(fraction) == second.percentile(fraction));
+    }
+    merged.merge(first);
+    CHECK(merged.count() == all.count() && merged.totalValue() == all.totalValue());
+    CHECK(merged.percentile(0.999) == all.percentile(0.999));
+}
+
+void checkDumperFlushesOnStop() {
+    const char *path = "check_instrumentation.json";
+    std::remove(path);
+    const hvac::MetricId metric = hvac::registerMetric("check.stop", hvac::MetricKind::Latency);
+    {
+        // Интервал длиннее проверки: выгрузить замеры может только stop()
+        hvac::MetricsDumper dumper(path, hvac::MetricsFormat::Json, std::chrono::hours(1));
+        for (int i = 0; i < 3; ++i) {
+            hvac::recordLatency(metric, 2000);
+        }
+        dumper.stop();
+    }
+
+    std::FILE *file = std::fopen(path, "rb");
+    CHECK(file != nullptr);
+    std::string text;
+    char chunk[512];
+    std::size_t length;
+    while ((length = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        text.append(chunk, length);
+    }
+    std::fclose(file);
+    std::remove(path);
+    CHECK(text.find("\"name\":\"check.stop\",\"kind\":\"latency\",\"count\":3,") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    checkBuckets();
+    checkPercentiles();
+    checkDumperFlushesOnStop();
+    std::puts("check_instrumentation: ok");
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Расписание уставок: переопределение "до переключения" (until = 0) после смены
+// программы заканчивается по новой программе; явный срок при этом не меняется
+#include "checkharness.h"
+#include "scheduleengine.h"
+
+#include <cstdio>
+
+namespace {
+
+constexpr hvac::ScheduleTime kHour = 3600;
+
+// Комфорт с from до to каждый день, остальное время — снижение
+hvac::SetpointProgram dailyProgram(std::uint32_t fromHour, std::uint32_t toHour, double comfort, double setback) {
+    hvac::SetpointProgram program;
+    program.comfortTemperature = comfort;
+    program.setbackTemperature = setback;
+    program.points.push_back({hvac::kEveryDay, fromHour * 3600, hvac::ScheduleMode::Comfort});
+    program.points.push_back({hvac::kEveryDay, toHour * 3600, hvac::ScheduleMode::Setback});
+    return program;
+}
+
+// Температура зоны в пакете; false, если зоны в пакете нет
+bool batchTemperature(const hvac::SetpointBatch &batch, hvac::ZoneStore::ZoneId zone, double &temperature) {
+    for (std::size_t i = 0; i < batch.zones.size(); ++i) {
+        if (batch.zones[i] == zone) {
+            temperature = batch.temperature[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void checkOverrideFollowsNewProgram() {
+    // Понедельник, 12:00
+    hvac::ScheduleEngine engine(3, 12 * kHour);
+    const hvac::ScheduleEngine::ProgramId office = engine.addProgram(dailyProgram(8, 18, 22.0, 17.0));
+    const hvac::ScheduleEngine::ProgramId evening = engine.addProgram(dailyProgram(6, 22, 23.0, 16.0));
+    hvac::SetpointBatch batch;
+    double temperature = 0;
+
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < 3; ++zone) {
+        CHECK(engine.assignProgram(zone, office));
+    }
+    CHECK(engine.advance(12 * kHour, batch) == 3);
+
+    CHECK(engine.overrideZone(0, 25.0, 40.0));                  // До переключения программы
+    CHECK(engine.overrideZone(1, 25.0, 40.0, 13 * kHour));      // Явный срок
+    CHECK(engine.overrideZone(2, 25.0, 40.0));
+    CHECK(engine.advance(12 * kHour, batch) == 3);
+
+    // Смена программы: зона 0 ждёт 22:00 новой программы, а не 18:00 прежней
+    CHECK(engine.assignProgram(0, evening));
+    CHECK(engine.assignProgram(1, evening));
+    CHECK(engine.assignProgram(2, hvac::ScheduleEngine::kNoProgram)); // Без программы — до clearOverride()
+    CHECK(engine.advance(12 * kHour, batch) == 0); // Переопределённым зонам уставка программы не выдаётся
+
+    engine.advance(13 * kHour, batch);
+    CHECK(batchTemperature(batch, 1, temperature) && temperature == 23.0); // Явный срок сохранён
+    CHECK(!engine.isOverridden(1));
+    CHECK(engine.isOverridden(0));
+
+    CHECK(engine.advance(18 * kHour, batch) == 0);
+    CHECK(engine.isOverridden(0));
+
+    engine.advance(22 * kHour, batch);
+    CHECK(!engine.isOverridden(0));
+    CHECK(batchTemperature(batch, 0, temperature) && temperature == 16.0);
+    CHECK(batchTemperature(batch, 1, temperature) && temperature == 16.0);
+
+    // Зона без программы остаётся переопределённой; новая программа задаёт срок
+    engine.advance(3 * 24 * kHour, batch);
+    CHECK(engine.isOverridden(2));
+    CHECK(!batchTemperature(batch, 2, temperature));
+    CHECK(engine.assignProgram(2, office));
+    CHECK(engine.advance(3 * 24 * kHour, batch) == 0);
+    engine.advance(3 * 24 * kHour + 8 * kHour, batch);
+    CHECK(!engine.isOverridden(2));
+    CHECK(batchTemperature(batch, 2, temperature) && temperature == 22.0);
+
+    // На каждую зону — только следующее переключение программы
+    CHECK(engine.pendingEvents() == 3);
+}
+
+void checkOverrideWithoutProgram() {
+    hvac::ScheduleEngine engine(1, 0);
+    hvac::SetpointBatch batch;
+    CHECK(engine.overrideZone(0, 21.0, 45.0));
+    CHECK(engine.pendingEvents() == 0);
+    CHECK(engine.advance(7 * 24 * kHour, batch) == 1);
+    CHECK(engine.isOverridden(0));
+    engine.clearOverride(0);
+    CHECK(!engine.isOverridden(0));
+}
+
+} // namespace
+
+int main() {
+    checkOverrideFollowsNewProgram();
+    checkOverrideWithoutProgram();
+    std::puts("check_scheduleengine: ok");
+    return 0;
+}
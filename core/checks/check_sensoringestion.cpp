@@ -0,0 +1,185 @@
+// Приём показаний из нескольких потоков: очередь MPSC ничего не теряет и не
+// повторяет, переполнение учитывается, drain() оставляет последнее показание зоны
+#include "checkharness.h"
+#include "mpscring.h"
+#include "sensoringestion.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kProducers = 4;
+
+void checkRingConcurrent() {
+    // Значение: номер производителя в старших битах, порядковый номер в младших
+    constexpr std::uint64_t kPerProducer = 200000;
+    hvac::MpscRing<std::uint64_t> ring(1024);
+    CHECK(ring.capacity() == 1024);
+
+    std::atomic<std::size_t> finished{0};
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, &finished, p]() {
+            for (std::uint64_t i = 0; i < kPerProducer; ++i) {
+                const std::uint64_t value = (static_cast<std::uint64_t>(p) << 32) | i;
+                while (!ring.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    // Порядок внутри одного производителя сохраняется, каждое значение ровно один раз
+    std::vector<std::uint64_t> next(kProducers, 0);
+    std::uint64_t popped = 0;
+    std::uint64_t value = 0;
+    for (;;) {
+        if (ring.tryPop(value)) {
+            const std::size_t p = static_cast<std::size_t>(value >> 32);
+            CHECK(p < kProducers);
+            CHECK((value & 0xffffffffu) == next[p]);
+            ++next[p];
+            ++popped;
+        } else if (finished.load() == kProducers) {
+            if (!ring.tryPop(value)) {
+                break;
+            }
+            const std::size_t p = static_cast<std::size_t>(value >> 32);
+            CHECK((value & 0xffffffffu) == next[p]);
+            ++next[p];
+            ++popped;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    CHECK(popped == kProducers * kPerProducer);
+    for (std::uint64_t count : next) {
+        CHECK(count == kPerProducer);
+    }
+}
+
+void checkDropCounting() {
+    // Без потребителя очередь принимает ровно ёмкость, остальное считается потерянным
+    constexpr std::size_t kCapacity = 256;
+    constexpr std::size_t kPerProducer = 1000;
+    hvac::SensorIngestion ingestion(8, kCapacity);
+
+    std::atomic<std::uint64_t> accepted{0};
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ingestion, &accepted, p]() {
+            for (std::size_t i = 0; i < kPerProducer; ++i) {
+                hvac::SensorSample sample;
+                sample.zone = static_cast<hvac::ZoneStore::ZoneId>(p);
+                sample.temperature = static_cast<double>(i);
+                if (ingestion.push(sample)) {
+                    accepted.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    CHECK(accepted.load() == kCapacity);
+    CHECK(ingestion.droppedCount() == kProducers * kPerProducer - kCapacity);
+
+    hvac::SensorBatch batch;
+    CHECK(ingestion.drain(batch) == kCapacity);
+    CHECK(ingestion.drain(batch) == 0);
+    CHECK(batch.size() == 0);
+
+    // После освобождения места показания снова принимаются
+    hvac::SensorSample sample;
+    CHECK(ingestion.push(sample));
+    CHECK(ingestion.droppedCount() == kProducers * kPerProducer - kCapacity);
+}
+
+void checkLatestWins() {
+    // Каждый производитель ведёт свои зоны; температура зоны равна номеру показания
+    constexpr std::size_t kZonesPerProducer = 16;
+    constexpr std::size_t kZones = kProducers * kZonesPerProducer;
+    constexpr std::size_t kRounds = 2000;
+    hvac::SensorIngestion ingestion(kZones + 1, kProducers * kZonesPerProducer * kRounds);
+
+    std::atomic<std::size_t> finished{0};
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ingestion, &finished, p]() {
+            for (std::size_t round = 1; round <= kRounds; ++round) {
+                for (std::size_t j = 0; j < kZonesPerProducer; ++j) {
+                    hvac::SensorSample sample;
+                    sample.zone = static_cast<hvac::ZoneStore::ZoneId>(p * kZonesPerProducer + j);
+                    sample.temperature = static_cast<double>(round);
+                    sample.humidity = static_cast<double>(sample.zone);
+                    sample.pressure = -static_cast<double>(round);
+                    CHECK(ingestion.push(sample));
+                }
+            }
+            // Показание неизвестной зоны не должно попасть в пакет
+            hvac::SensorSample unknown;
+            unknown.zone = static_cast<hvac::ZoneStore::ZoneId>(kZones + 1 + p);
+            CHECK(ingestion.push(unknown));
+            finished.fetch_add(1);
+        });
+    }
+
+    std::vector<double> last(kZones, 0.0);
+    std::uint64_t taken = 0;
+    hvac::SensorBatch batch;
+    bool done = false;
+    while (!done) {
+        done = finished.load() == kProducers;
+        // Небольшие порции: пакет собирается из части очереди, пока производители пишут
+        const std::size_t count = ingestion.drain(batch, 97);
+        taken += count;
+        CHECK(batch.size() <= count);
+        CHECK(batch.temperature.size() == batch.size());
+        CHECK(batch.humidity.size() == batch.size());
+        CHECK(batch.pressure.size() == batch.size());
+        std::vector<bool> seen(kZones + 1, false);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            const hvac::ZoneStore::ZoneId zone = batch.zones[i];
+            CHECK(zone < kZones);
+            CHECK(!seen[zone]); // Зона в пакете один раз
+            seen[zone] = true;
+            // Показание новее всех опубликованных раньше: ни повторов, ни отката назад
+            CHECK(batch.temperature[i] > last[zone]);
+            CHECK(batch.humidity[i] == static_cast<double>(zone));
+            CHECK(batch.pressure[i] == -batch.temperature[i]);
+            last[zone] = batch.temperature[i];
+        }
+        if (count > 0) {
+            done = false;
+        } else if (!done) {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    CHECK(taken == kProducers * (kZonesPerProducer * kRounds + 1));
+    CHECK(ingestion.droppedCount() == 0);
+    for (double value : last) {
+        CHECK(value == static_cast<double>(kRounds)); // Итоговое показание каждой зоны опубликовано
+    }
+}
+
+} // namespace
+
+int main() {
+    checkRingConcurrent();
+    checkDropCounting();
+    checkLatestWins();
+    std::puts("check_sensoringestion: ok");
+    return 0;
+}
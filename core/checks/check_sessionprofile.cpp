@@ -0,0 +1,165 @@
+// Профиль сеанса: двоичный файл переживает запись и чтение без потерь, а
+// оборванный, испорченный или чужой версии файл отвергается без изменения профиля
+#include "checkharness.h"
+#include "sessionprofile.h"
+#include "zonestore.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *const kProfilePath = "check_sessionprofile.bin";
+constexpr std::size_t kHeaderSize = 20;
+constexpr std::size_t kVersionOffset = 4;
+
+std::vector<unsigned char> readFile(const char *path) {
+    std::vector<unsigned char> data;
+    std::FILE *file = std::fopen(path, "rb");
+    CHECK(file != nullptr);
+    unsigned char chunk[1024];
+    std::size_t length;
+    while ((length = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + length);
+    }
+    std::fclose(file);
+    return data;
+}
+
+void writeFile(const char *path, const std::vector<unsigned char> &data) {
+    std::FILE *file = std::fopen(path, "wb");
+    CHECK(file != nullptr);
+    CHECK(data.empty() || std::fwrite(data.data(), 1, data.size(), file) == data.size());
+    CHECK(std::fclose(file) == 0);
+}
+
+// Та же FNV-1a, что и в файле: подделка, которую контрольная сумма не ловит
+void resealChecksum(std::vector<unsigned char> &data) {
+    const std::size_t payload = data.size() - sizeof(std::uint32_t);
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < payload; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    std::memcpy(data.data() + payload, &hash, sizeof(hash));
+}
+
+hvac::SessionProfile sampleProfile() {
+    hvac::ZoneStore store(5);
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < store.size(); ++zone) {
+        store.setSetpoint(zone, 19.5 + zone, 40.0 + 2.5 * zone);
+    }
+    hvac::SessionProfile profile;
+    profile.width = 1920;
+    profile.height = 1080;
+    profile.theme = hvac::Theme::Dark;
+    profile.temperatureUnit = hvac::TemperatureUnit::Fahrenheit;
+    profile.pressureUnit = hvac::PressureUnit::MmHg;
+    profile.selectedZone = 3;
+    profile.captureSetpoints(store);
+    return profile;
+}
+
+bool sameProfile(const hvac::SessionProfile &a, const hvac::SessionProfile &b) {
+    if (a.width != b.width || a.height != b.height || a.theme != b.theme ||
+        a.temperatureUnit != b.temperatureUnit || a.pressureUnit != b.pressureUnit ||
+        a.selectedZone != b.selectedZone || a.setpoints.size() != b.setpoints.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.setpoints.size(); ++i) {
+        if (a.setpoints[i].temperature != b.setpoints[i].temperature ||
+            a.setpoints[i].humidity != b.setpoints[i].humidity) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Файл отвергнут, профиль остался прежним
+void expectRejected(const std::vector<unsigned char> &data) {
+    writeFile(kProfilePath, data);
+    hvac::SessionProfile untouched;
+    const hvac::SessionProfile defaults;
+    CHECK(!hvac::loadSessionProfile(kProfilePath, untouched));
+    CHECK(sameProfile(untouched, defaults));
+}
+
+void checkRoundTrip() {
+    const hvac::SessionProfile saved = sampleProfile();
+    CHECK(hvac::saveSessionProfile(kProfilePath, saved));
+    CHECK(readFile(kProfilePath).size() == kHeaderSize + 5 * sizeof(hvac::ProfileSetpoint) + sizeof(std::uint32_t));
+
+    hvac::SessionProfile loaded;
+    CHECK(hvac::loadSessionProfile(kProfilePath, loaded));
+    CHECK(sameProfile(loaded, saved));
+
+    // Уставки возвращаются в хранилище; лишние зоны профиля пропускаются
+    hvac::ZoneStore store(3);
+    loaded.applySetpoints(store);
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < store.size(); ++zone) {
+        CHECK_NEAR(store.snapshot(zone).setpointTemperature, 19.5 + zone, 1e-6);
+        CHECK_NEAR(store.snapshot(zone).setpointHumidity, 40.0 + 2.5 * zone, 1e-6);
+    }
+
+    // Профиль без зон тоже читается
+    hvac::SessionProfile empty;
+    CHECK(hvac::saveSessionProfile(kProfilePath, empty));
+    loaded = saved;
+    CHECK(hvac::loadSessionProfile(kProfilePath, loaded));
+    CHECK(sameProfile(loaded, empty));
+
+    hvac::SessionProfile missing;
+    CHECK(!hvac::loadSessionProfile("check_sessionprofile.missing", missing));
+}
+
+void checkCorruptFiles() {
+    CHECK(hvac::saveSessionProfile(kProfilePath, sampleProfile()));
+    const std::vector<unsigned char> good = readFile(kProfilePath);
+
+    // Обрыв записи на любой длине, включая пустой файл
+    for (std::size_t size = 0; size < good.size(); ++size) {
+        expectRejected(std::vector<unsigned char>(good.begin(), good.begin() + size));
+    }
+    std::vector<unsigned char> longer = good;
+    longer.push_back(0);
+    expectRejected(longer);
+
+    // Один изменённый байт в любом месте, в том числе в самой контрольной сумме
+    for (std::size_t i = 0; i < good.size(); ++i) {
+        std::vector<unsigned char> flipped = good;
+        flipped[i] ^= 0x01;
+        expectRejected(flipped);
+    }
+
+    // Другая версия формата с верной контрольной суммой
+    for (std::uint16_t version : {std::uint16_t(0), std::uint16_t(2), std::uint16_t(0xFFFF)}) {
+        std::vector<unsigned char> other = good;
+        std::memcpy(other.data() + kVersionOffset, &version, sizeof(version));
+        resealChecksum(other);
+        expectRejected(other);
+    }
+
+    // Недопустимое значение перечисления с верной контрольной суммой
+    std::vector<unsigned char> badTheme = good;
+    badTheme[12] = 7;
+    resealChecksum(badTheme);
+    expectRejected(badTheme);
+
+    // Контроль: неизменённый файл по-прежнему читается
+    writeFile(kProfilePath, good);
+    hvac::SessionProfile loaded;
+    CHECK(hvac::loadSessionProfile(kProfilePath, loaded));
+    CHECK(sameProfile(loaded, sampleProfile()));
+}
+
+} // namespace
+
+int main() {
+    checkRoundTrip();
+    checkCorruptFiles();
+    std::remove(kProfilePath);
+    std::puts("check_sessionprofile: ok");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Пакетный расчёт: итоги не должны зависеть от шага профиля нагрузки
+// (модель считается шагами не длиннее SweepOptions::maxTimeStep); CSV профиля
+// с чрезмерно длинной строкой отвергается, а не режется на две строки
+#include "checkharness.h"
+#include "parametersweep.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double kDay = 86400.0;
+
+hvac::SweepReport run(hvac::WorkStealingPool &pool, const hvac::SweepGrid &grid, double timeStep) {
+    hvac::ClimateProfile climate;
+    std::vector<hvac::LoadProfile> profiles;
+    profiles.push_back(hvac::syntheticLoadProfile(climate, 14 * kDay, 7 * kDay, timeStep));  // Январь
+    profiles.push_back(hvac::syntheticLoadProfile(climate, 195 * kDay, 7 * kDay, timeStep)); // Июль
+    hvac::SweepEvaluator evaluator(pool);
+    hvac::SweepReport report;
+    CHECK(evaluator.evaluate(grid, profiles, report));
+    return report;
+}
+
+void writeText(const char *path, const std::string &text) {
+    std::FILE *file = std::fopen(path, "w");
+    CHECK(file != nullptr);
+    CHECK(std::fputs(text.c_str(), file) >= 0);
+    CHECK(std::fclose(file) == 0);
+}
+
+void checkLoadProfileCsv() {
+    const char *path = "check_sweep.csv";
+    hvac::LoadProfile profile;
+
+    // Последняя строка без перевода строки допустима
+    writeText(path, "# наружная,занятость\n-5.5,0\n-4,1\n-3.25;0.5");
+    CHECK(hvac::loadLoadProfileCsv(path, 300.0, profile));
+    CHECK(profile.steps() == 3);
+    CHECK(profile.outdoorTemperature[2] == -3.25 && profile.occupancy[2] == 0.5);
+
+    // Первые 255 символов сами по себе — верная строка "21.5,0.000...", хвост "5,1" — тоже;
+    // раньше такой файл читался как две строки профиля
+    const std::string longLine = "21.5,0." + std::string(248, '0') + "5,1\n";
+    writeText(path, "-5.5,0\n" + longLine + "-4,1\n");
+    hvac::LoadProfile untouched = profile;
+    CHECK(!hvac::loadLoadProfileCsv(path, 300.0, untouched));
+    CHECK(untouched.steps() == 3);
+
+    writeText(path, "-5.5,0\n" + std::string(400, '#') + "\n-4,1\n"); // Длинный комментарий тоже
+    CHECK(!hvac::loadLoadProfileCsv(path, 300.0, untouched));
+    std::remove(path);
+}
+
+} // namespace
+
+int main() {
+    checkLoadProfileCsv();
+
+    hvac::WorkStealingPool pool(2);
+    hvac::SweepGrid grid;
+    grid.temperatureSetpoints = {20.0, 22.0, 24.0};
+    grid.acPolicies = {hvac::ACPolicy::AlwaysOn, hvac::ACPolicy::Occupied};
+
+    const hvac::SweepReport fine = run(pool, grid, 300.0);
+    const hvac::SweepReport coarse = run(pool, grid, 3600.0);
+    CHECK(fine.configurationCount == grid.size() && coarse.configurationCount == grid.size());
+
+    for (std::size_t configuration = 0; configuration < grid.size(); ++configuration) {
+        const hvac::SweepMetrics &a = fine.total[configuration];
+        const hvac::SweepMetrics &b = coarse.total[configuration];
+        CHECK_NEAR(a.occupiedHours, b.occupiedHours, 1e-6);
+        CHECK(a.energyKWh > 0);
+        CHECK_NEAR(b.energyKWh, a.energyKWh, 0.02 * a.energyKWh);
+        // Наружная температура часового профиля грубее, поэтому допуск по комфорту шире
+        CHECK_NEAR(b.discomfortDegreeHours, a.discomfortDegreeHours, 1.0 + 0.05 * a.discomfortDegreeHours);
+        CHECK_NEAR(b.hoursOutsideBand, a.hoursOutsideBand, 8.0 + 0.1 * a.hoursOutsideBand);
+    }
+
+    // Вариант 22 °C / 45 % / всегда включён держит комфорт на обоих шагах
+    const std::size_t comfortable = 2;
+    CHECK(grid.configuration(comfortable).temperatureSetpoint == 22.0);
+    CHECK(grid.configuration(comfortable).policy == hvac::ACPolicy::AlwaysOn);
+    CHECK(coarse.total[comfortable].discomfortDegreeHours < 0.5);
+    std::puts("check_sweep: ok");
+    return 0;
+}
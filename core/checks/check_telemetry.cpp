@@ -0,0 +1,182 @@
+// Журнал телеметрии: запись → отображение в память → проигрывание, в том числе
+// ограниченные приращения, пропуск времени и дозапись в существующий журнал
+#include "checkharness.h"
+#include "telemetry.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *const kPath = "check_telemetry.bin";
+
+hvac::TelemetryEvent makeEvent(hvac::TelemetryType type, hvac::ZoneStore::ZoneId zone, std::int64_t timestampMs,
+                               double a, double b = 0, double c = 0) {
+    hvac::TelemetryEvent event;
+    event.type = type;
+    event.zone = zone;
+    event.timestampMs = timestampMs;
+    event.values[0] = a;
+    event.values[1] = b;
+    event.values[2] = c;
+    return event;
+}
+
+std::vector<hvac::TelemetryEvent> readAll(const char *path) {
+    hvac::TelemetryReader reader;
+    CHECK(reader.open(path));
+    std::vector<hvac::TelemetryEvent> events;
+    hvac::TelemetryReader::Cursor cursor(reader);
+    hvac::TelemetryEvent event;
+    while (cursor.next(event)) {
+        events.push_back(event);
+    }
+    return events;
+}
+
+std::size_t recordCountOf(const char *path) {
+    hvac::TelemetryReader reader;
+    CHECK(reader.open(path));
+    return reader.recordCount();
+}
+
+void checkRoundTrip() {
+    std::remove(kPath);
+    const std::int64_t start = hvac::telemetryNowMs() + 1000;
+    {
+        hvac::TelemetryWriter writer(kPath);
+        CHECK(writer.isOpen());
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start, 21.5, 40.25, 101325.3));
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 1, start + 10, 19.0, 55.0, 100900.0));
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start + 20, 21.5, 40.25, 101325.3)); // Без изменений
+        writer.log(makeEvent(hvac::TelemetryType::Setpoint, 1, start + 30, 23.0, 45.0));
+        writer.log(makeEvent(hvac::TelemetryType::ACStatus, 1, start + 40, 1));
+        writer.log(makeEvent(hvac::TelemetryType::Louver, 0, start + 50, 135, 20));
+        writer.close();
+        CHECK(writer.droppedCount() == 0);
+    }
+
+    const std::vector<hvac::TelemetryEvent> events = readAll(kPath);
+    CHECK(events.size() == 5); // Неизменившееся показание не записано
+    CHECK(events[0].type == hvac::TelemetryType::Reading && events[0].zone == 0);
+    CHECK(events[0].timestampMs == start);
+    CHECK_NEAR(events[0].values[0], 21.5, 1e-9);
+    CHECK_NEAR(events[0].values[1], 40.25, 1e-9);
+    CHECK_NEAR(events[0].values[2], 101325.3, 1e-9);
+    CHECK(events[1].zone == 1 && events[1].timestampMs == start + 10);
+    CHECK_NEAR(events[1].values[2], 100900.0, 1e-9);
+    CHECK(events[2].type == hvac::TelemetryType::Setpoint && events[2].timestampMs == start + 30);
+    CHECK_NEAR(events[2].values[0], 23.0, 1e-9);
+    CHECK(events[3].type == hvac::TelemetryType::ACStatus && events[3].values[0] == 1);
+    CHECK(events[4].type == hvac::TelemetryType::Louver && events[4].values[0] == 135 && events[4].values[1] == 20);
+
+    hvac::TelemetryReader reader;
+    CHECK(reader.open(kPath));
+    hvac::ZoneStore store(2);
+    CHECK(hvac::replayTelemetry(reader, store) == 5);
+    CHECK_NEAR(store.temperature(0), 21.5, 1e-9);
+    CHECK_NEAR(store.humidity(1), 55.0, 1e-9);
+    CHECK_NEAR(store.snapshot(1).setpointTemperature, 23.0, 1e-9);
+    CHECK(store.acStatus(1));
+    CHECK(store.snapshot(0).louverPan == 135 && store.snapshot(0).louverTilt == 20);
+    // Проигрывание до момента: только первые два события
+    hvac::ZoneStore partial(2);
+    CHECK(hvac::replayTelemetry(reader, partial, start + 15) == 2);
+}
+
+void checkClampedDelta() {
+    std::remove(kPath);
+    const std::int64_t start = hvac::telemetryNowMs() + 1000;
+    const std::int64_t jump = std::int64_t(6000000000); // Больше 32 бит миллисекунд
+    {
+        hvac::TelemetryWriter writer(kPath);
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start, 22.0, 40.0, 101325.0));
+        // +378 °C не помещается в int16 сотых: записывается +327.67, остаток — следующей записью
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start + 1, 400.0, 40.0, 101325.0));
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start + 2, 400.0, 40.0, 101325.0));
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start + 2 + jump, 21.0, 40.0, 101325.0));
+    }
+
+    const std::vector<hvac::TelemetryEvent> events = readAll(kPath);
+    CHECK(events.size() == 4);
+    CHECK_NEAR(events[1].values[0], 22.0 + 327.67, 1e-9);
+    CHECK_NEAR(events[2].values[0], 400.0, 1e-9); // Догнали точное значение
+    CHECK_NEAR(events[3].values[0], 400.0 - 327.68, 1e-9); // Спад тоже ограничен int16
+    CHECK(events[3].timestampMs == start + 2 + jump);
+    CHECK(recordCountOf(kPath) == 5); // Плюс запись TimeJump
+}
+
+void checkAppend() {
+    std::remove(kPath);
+    const std::int64_t start = hvac::telemetryNowMs() + 1000;
+    {
+        hvac::TelemetryWriter writer(kPath);
+        for (int i = 0; i < 6; ++i) {
+            writer.log(makeEvent(hvac::TelemetryType::Reading, 0, start + i, 20.0 + i, 40.0, 101325.0));
+        }
+    }
+    CHECK(recordCountOf(kPath) == 6);
+
+    // Оборванная запись прошлого сеанса не должна сдвигать новые
+    std::FILE *file = std::fopen(kPath, "ab");
+    CHECK(file != nullptr);
+    std::fwrite("\x01\x02\x03\x04\x05\x06\x07", 1, 7, file);
+    std::fclose(file);
+
+    const std::int64_t later = hvac::telemetryNowMs() + 5000;
+    {
+        hvac::TelemetryWriter writer(kPath);
+        CHECK(writer.isOpen());
+        writer.log(makeEvent(hvac::TelemetryType::Reading, 0, later, 18.5, 41.0, 101000.0));
+        writer.log(makeEvent(hvac::TelemetryType::Louver, 3, later + 5, 90, 30));
+    }
+    CHECK(recordCountOf(kPath) == 9); // 6 старых + Segment + 2 новых
+
+    const std::vector<hvac::TelemetryEvent> events = readAll(kPath);
+    CHECK(events.size() == 8);
+    CHECK_NEAR(events[5].values[0], 25.0, 1e-9);
+    CHECK(events[5].timestampMs == start + 5);
+    // Значения нового сеанса не складываются с состоянием прошлого
+    CHECK(events[6].timestampMs == later);
+    CHECK_NEAR(events[6].values[0], 18.5, 1e-9);
+    CHECK_NEAR(events[6].values[1], 41.0, 1e-9);
+    CHECK_NEAR(events[6].values[2], 101000.0, 1e-9);
+    CHECK(events[7].zone == 3 && events[7].values[0] == 90 && events[7].values[1] == 30);
+    CHECK(events[7].timestampMs == later + 5);
+}
+
+void checkForeignFile() {
+    std::remove(kPath);
+    const char text[] = "zone,temperature,humidity\n1,22,45\n";
+    std::FILE *file = std::fopen(kPath, "wb");
+    CHECK(file != nullptr);
+    std::fwrite(text, 1, sizeof(text) - 1, file);
+    std::fclose(file);
+
+    {
+        hvac::TelemetryWriter writer(kPath);
+        CHECK(!writer.isOpen());
+        CHECK(!writer.logACStatus(0, true));
+    }
+    // Файл остался нетронутым
+    file = std::fopen(kPath, "rb");
+    CHECK(file != nullptr);
+    char content[sizeof(text)] = {};
+    CHECK(std::fread(content, 1, sizeof(content), file) == sizeof(text) - 1);
+    std::fclose(file);
+    CHECK(std::string(content) == text);
+}
+
+} // namespace
+
+int main() {
+    checkRoundTrip();
+    checkClampedDelta();
+    checkAppend();
+    checkForeignFile();
+    std::remove(kPath);
+    std::puts("check_telemetry: ok");
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Колесо таймеров: порядок срабатывания и отмена на всех уровнях, в том числе
+// после спуска события на нижний уровень и для устаревших ссылок
+#include "checkharness.h"
+#include "timerwheel.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Wheel = hvac::TimerWheel<std::uint32_t>;
+
+void checkLevels() {
+    // По событию на границе каждого уровня и рядом с ней, вставка в обратном порядке
+    const Wheel::Tick start = 5;
+    Wheel wheel(start);
+    std::vector<Wheel::Tick> ticks = {start, start + 1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144,
+                                      Wheel::Tick(1) << 24, (Wheel::Tick(1) << 30) + 7, Wheel::Tick(1) << 36,
+                                      (Wheel::Tick(1) << 42) - 1, Wheel::Tick(1) << 48};
+    for (std::size_t i = ticks.size(); i-- > 0;) {
+        wheel.schedule(ticks[i], static_cast<std::uint32_t>(i));
+    }
+    wheel.schedule(1, 1000); // В прошлом: срабатывает в текущем тике
+    CHECK(wheel.size() == ticks.size() + 1);
+
+    std::vector<Wheel::Fired> fired;
+    CHECK(wheel.advance(start, fired) == 2);
+    CHECK(fired[0].tick == start && fired[1].tick == start);
+    CHECK((fired[0].payload == 0 && fired[1].payload == 1000) || (fired[0].payload == 1000 && fired[1].payload == 0));
+
+    // По шагам: ничего не срабатывает раньше срока
+    fired.clear();
+    CHECK(wheel.advance(4095, fired) == 5);
+    CHECK(wheel.now() == 4096);
+    fired.clear();
+    wheel.advance(~Wheel::Tick(0) - 1, fired);
+    CHECK(fired.size() == ticks.size() - 6);
+    for (std::size_t i = 0; i < fired.size(); ++i) {
+        CHECK(fired[i].payload == i + 6);
+        CHECK(fired[i].tick == ticks[i + 6]);
+    }
+    CHECK(wheel.size() == 0);
+}
+
+void checkCancel() {
+    Wheel wheel(0);
+    const Wheel::Handle nearEvent = wheel.schedule(10, 1);
+    const Wheel::Handle farEvent = wheel.schedule(300000, 2);  // Уровень 3
+    const Wheel::Handle keptEvent = wheel.schedule(300001, 3); // Та же ячейка уровня 3
+    CHECK(wheel.cancel(nearEvent));
+    CHECK(!wheel.cancel(nearEvent)); // Повторная отмена
+
+    // Спуск: после прохода 262144 оба дальних события лежат ниже уровня 3
+    std::vector<Wheel::Fired> fired;
+    CHECK(wheel.advance(299999, fired) == 0);
+    CHECK(wheel.cancel(farEvent));
+    CHECK(wheel.advance(400000, fired) == 1);
+    CHECK(fired[0].payload == 3 && fired[0].tick == 300001);
+    CHECK(!wheel.cancel(keptEvent)); // Уже сработало
+
+    // Узел переиспользуется, а старая ссылка на него недействительна
+    const Wheel::Handle reused = wheel.schedule(400010, 4);
+    CHECK(reused.index == keptEvent.index || reused.index == farEvent.index || reused.index == nearEvent.index);
+    CHECK(!wheel.cancel(keptEvent) && !wheel.cancel(farEvent) && !wheel.cancel(nearEvent));
+    CHECK(wheel.size() == 1);
+    CHECK(wheel.cancel(reused));
+    CHECK(wheel.size() == 0);
+    fired.clear();
+    CHECK(wheel.advance(500000, fired) == 0);
+}
+
+void checkRandomAgainstReference() {
+    std::mt19937_64 random(12345);
+    const Wheel::Tick start = (Wheel::Tick(1) << 40) - 1000; // Проход через границу верхних уровней
+    Wheel wheel(start);
+
+    constexpr std::size_t kEvents = 20000;
+    std::vector<Wheel::Tick> when(kEvents);
+    std::vector<Wheel::Handle> handles(kEvents);
+    std::vector<std::uint8_t> cancelled(kEvents, 0);
+    for (std::size_t i = 0; i < kEvents; ++i) {
+        // Задержки от 0 до 2^38 с равномерным по уровням распределением
+        const unsigned bits = static_cast<unsigned>(random() % 39);
+        const Wheel::Tick delay = bits == 0 ? 0 : random() % (Wheel::Tick(1) << bits);
+        when[i] = start + delay;
+        handles[i] = wheel.schedule(when[i], static_cast<std::uint32_t>(i));
+    }
+
+    std::vector<std::uint8_t> firedOnce(kEvents, 0);
+    std::vector<Wheel::Fired> fired;
+    Wheel::Tick until = start;
+    Wheel::Tick lastTick = start;
+    const Wheel::Tick end = start + (Wheel::Tick(1) << 38);
+    while (until < end) {
+        // Отменяем часть ещё не сработавших событий между шагами
+        for (int k = 0; k < 20; ++k) {
+            const std::size_t i = random() % kEvents;
+            const bool expected = !firedOnce[i] && !cancelled[i];
+            CHECK(wheel.cancel(handles[i]) == expected);
+            cancelled[i] |= expected ? 1 : 0;
+        }
+
+        until += random() % (Wheel::Tick(1) << (random() % 34));
+        fired.clear();
+        wheel.advance(until, fired);
+        for (const Wheel::Fired &event : fired) {
+            const std::uint32_t i = event.payload;
+            CHECK(!cancelled[i] && !firedOnce[i]);
+            CHECK(event.tick == when[i]);
+            CHECK(event.tick >= lastTick && event.tick <= until);
+            lastTick = event.tick;
+            firedOnce[i] = 1;
+        }
+        // Всё, что должно было сработать к until, сработало
+        CHECK(wheel.now() == until + 1);
+    }
+    for (std::size_t i = 0; i < kEvents; ++i) {
+        CHECK(firedOnce[i] != cancelled[i]);
+    }
+    CHECK(wheel.size() == 0);
+}
+
+} // namespace
+
+int main() {
+    checkLevels();
+    checkCancel();
+    checkRandomAgainstReference();
+    std::puts("check_timerwheel: ok");
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Пакетный пересчёт единиц: SIMD-ядра совпадают со скалярным побитно на всех
+// длинах хвоста, пересчёт на месте и обратный план возвращают исходные значения
+#include "checkharness.h"
+#include "units.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const std::size_t kCounts[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 12, 15, 16, 17, 33, 1000};
+
+const hvac::AffineConversion kConversions[] = {
+    hvac::temperatureConversion(hvac::TemperatureUnit::Celsius, hvac::TemperatureUnit::Fahrenheit),
+    hvac::temperatureConversion(hvac::TemperatureUnit::Fahrenheit, hvac::TemperatureUnit::Kelvin),
+    hvac::pressureConversion(hvac::PressureUnit::Pascal, hvac::PressureUnit::MmHg),
+};
+
+std::vector<double> samples(std::size_t count) {
+    std::vector<double> values(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = -40.0 + 0.37 * static_cast<double>(i) + 1e-9 * static_cast<double>(i % 7);
+    }
+    return values;
+}
+
+bool sameBits(const double *a, const double *b, std::size_t count) {
+    return count == 0 || std::memcmp(a, b, count * sizeof(double)) == 0;
+}
+
+void checkKernelsMatchScalar() {
+    const std::vector<hvac::NamedConversionKernel> kernels = hvac::availableConversionKernels();
+    CHECK(!kernels.empty());
+    CHECK(std::strcmp(kernels[0].name, "scalar") == 0);
+    const hvac::ConversionKernel scalar = kernels[0].kernel;
+
+    bool selectedListed = false;
+    for (const hvac::NamedConversionKernel &kernel : kernels) {
+        selectedListed = selectedListed || kernel.kernel == hvac::conversionKernel();
+    }
+    CHECK(selectedListed);
+
+    for (const hvac::NamedConversionKernel &kernel : kernels) {
+        for (const hvac::AffineConversion &conversion : kConversions) {
+            for (std::size_t count : kCounts) {
+                // Смещение на один элемент: невыровненные загрузки и сохранения
+                for (std::size_t shift = 0; shift < 2; ++shift) {
+                    const std::vector<double> source = samples(count + shift);
+                    std::vector<double> expected(count + shift + 1, -1.0);
+                    std::vector<double> actual(count + shift + 1, -1.0);
+                    scalar(source.data() + shift, expected.data() + shift, count, conversion.scale,
+                           conversion.offset);
+                    kernel.kernel(source.data() + shift, actual.data() + shift, count, conversion.scale,
+                                  conversion.offset);
+                    CHECK(sameBits(expected.data(), actual.data(), actual.size())); // Хвост за count не тронут
+                    for (std::size_t i = 0; i < count; ++i) {
+                        CHECK(actual[shift + i] == conversion.apply(source[shift + i]));
+                    }
+
+                    // Пересчёт на месте даёт тот же результат
+                    std::vector<double> inPlace = source;
+                    kernel.kernel(inPlace.data() + shift, inPlace.data() + shift, count, conversion.scale,
+                                  conversion.offset);
+                    CHECK(sameBits(inPlace.data() + shift, expected.data() + shift, count));
+                    CHECK(sameBits(inPlace.data(), source.data(), shift));
+                }
+            }
+        }
+    }
+}
+
+void checkPlans() {
+    using T = hvac::TemperatureUnit;
+    using P = hvac::PressureUnit;
+    const T temperatures[] = {T::Celsius, T::Fahrenheit, T::Kelvin};
+    const P pressures[] = {P::Pascal, P::MmHg};
+
+    for (std::size_t count : kCounts) {
+        const std::vector<double> source = samples(count);
+        for (T from : temperatures) {
+            for (T to : temperatures) {
+                const hvac::ConversionPlan forward = hvac::planConversion(from, to);
+                const hvac::ConversionPlan inverse = hvac::planConversion(to, from);
+                std::vector<double> values = source;
+                forward.apply(values.data(), values.data(), count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    CHECK(values[i] == forward.apply(source[i]));
+                    CHECK(values[i] == hvac::convertTemperature(source[i], from, to));
+                }
+                inverse.apply(values.data(), values.data(), count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    CHECK_NEAR(values[i], source[i], 1e-9);
+                }
+            }
+        }
+        for (P from : pressures) {
+            for (P to : pressures) {
+                std::vector<double> pascals(count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    pascals[i] = 95000.0 + 13.0 * source[i];
+                }
+                std::vector<double> converted(count);
+                hvac::planConversion(from, to).apply(pascals.data(), converted.data(), count);
+                hvac::planConversion(to, from).apply(converted.data(), converted.data(), count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    CHECK_NEAR(converted[i], pascals[i], 1e-7);
+                }
+            }
+        }
+    }
+
+    // Шаблонная версия использует то же ядро
+    const std::vector<double> source = samples(9);
+    std::vector<double> planned(9);
+    std::vector<double> templated(9);
+    hvac::planConversion(T::Celsius, T::Kelvin).apply(source.data(), planned.data(), source.size());
+    hvac::convertTemperatures<T::Celsius, T::Kelvin>(source.data(), templated.data(), source.size());
+    CHECK(sameBits(planned.data(), templated.data(), source.size()));
+}
+
+} // namespace
+
+int main() {
+    checkKernelsMatchScalar();
+    checkPlans();
+    std::printf("check_units: ok (%s)\n", hvac::conversionKernelName());
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef CHECKHARNESS_H
+#define CHECKHARNESS_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @file checkharness.h
+ * @brief Проверки для исполняемых файлов ctest без внешних зависимостей.
+ *
+ * CHECK работает и в Release (в отличие от assert): при нарушении печатает
+ * файл, строку и условие и завершает процесс с ненулевым кодом.
+ */
+#define CHECK(condition)                                                                                 \
+    do {                                                                                                 \
+        if (!(condition)) {                                                                              \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);           \
+            std::exit(1);                                                                                \
+        }                                                                                                \
+    } while (false)
+
+// Сравнение чисел с плавающей точкой с допуском; при отказе печатает оба значения
+#define CHECK_NEAR(actual, expected, tolerance)                                                          \
+    do {                                                                                                 \
+        const double checkActual = (actual);                                                             \
+        const double checkExpected = (expected);                                                         \
+        if (!(std::fabs(checkActual - checkExpected) <= (tolerance))) {                                  \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__,     \
+                         #actual, #expected, checkActual, checkExpected);                                \
+            std::exit(1);                                                                                \
+        }                                                                                                \
+    } while (false)
+
+#endif // CHECKHARNESS_H
@@ -0,0 +1,608 @@
+#include "controlserver.h"
+#include "inputvalidation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace hvac {
+
+namespace {
+constexpr std::size_t kReadChunk = 64 * 1024;
+constexpr std::size_t kMaxOutputBacklog = 1 << 20; // Дальше не читаем, пока клиент не заберёт ответы
+constexpr int kMaxEvents = 64;
+
+template <typename Field>
+Field toFixed(double value, double scale) {
+    return static_cast<Field>(std::lround(value * scale));
+}
+
+void fillState(const ZoneSnapshot &zone, ControlResponse &response) {
+    response.temperature = toFixed<std::int32_t>(zone.temperature, 100.0);
+    response.humidity = toFixed<std::int32_t>(zone.humidity, 100.0);
+    response.pressure = toFixed<std::int32_t>(zone.pressure, 10.0);
+    response.setpointTemperature = toFixed<std::int16_t>(zone.setpointTemperature, 100.0);
+    response.setpointHumidity = toFixed<std::uint16_t>(zone.setpointHumidity, 100.0);
+    response.acOn = zone.acOn ? 1 : 0;
+    response.louverPan = zone.louverPan;
+    response.louverTilt = zone.louverTilt;
+}
+
+#ifndef _WIN32
+bool sendAll(int fd, const void *data, std::size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        const ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool receiveAll(int fd, void *data, std::size_t size) {
+    char *bytes = static_cast<char *>(data);
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+bool fillUnixAddress(const std::string &path, sockaddr_un &address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+sockaddr_in loopbackAddress(std::uint16_t port) {
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+#endif
+} // namespace
+
+void applyControlCommand(ZoneStore &store, const ControlCommand &command) {
+    if (command.zone >= store.size()) {
+        return;
+    }
+    switch (command.opcode) {
+    case ControlOpcode::SetSetpoint:
+        store.setSetpoint(command.zone, command.temperature, command.humidity);
+        break;
+    case ControlOpcode::SetAC:
+        store.setACStatus(command.zone, command.acAction == ControlACAction::Toggle
+                                            ? !store.acStatus(command.zone)
+                                            : command.acAction == ControlACAction::On);
+        break;
+    case ControlOpcode::SetLouver:
+        store.setLouver(command.zone, command.pan, command.tilt);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Клиентское соединение сервера: недочитанный хвост запросов и неотправленные ответы.
+ */
+struct ControlServer::Connection {
+    int fd = -1;
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> output;
+    std::size_t outputOffset = 0;
+    std::uint32_t events = 0;  // Маска, под которой соединение сейчас в epoll
+    bool peerClosed = false;   // Клиент закрыл запись: дописываем ответы и закрываем
+};
+
+ControlServer::ControlServer(std::size_t maxPendingCommands)
+    : maxPending(std::max<std::size_t>(maxPendingCommands, 1)) {
+}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+void ControlServer::publish(const ZoneStore &store) {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    published.resize(store.size());
+    for (std::size_t zone = 0; zone < published.size(); ++zone) {
+        published[zone] = store.snapshot(static_cast<ZoneStore::ZoneId>(zone));
+    }
+}
+
+std::size_t ControlServer::drain(std::vector<ControlCommand> &out) {
+    out.clear();
+    std::lock_guard<std::mutex> lock(commandMutex);
+    out.swap(pending); // Буферы меняются местами, память переиспользуется
+    return out.size();
+}
+
+std::size_t ControlServer::applyPending(ZoneStore &store) {
+    std::vector<ControlCommand> commands;
+    drain(commands);
+    for (const ControlCommand &command : commands) {
+        applyControlCommand(store, command);
+    }
+    return commands.size();
+}
+
+void ControlServer::handleRequest(const ControlRequest &request, ControlResponse &response) {
+    std::memset(&response, 0, sizeof(response));
+    response.opcode = request.opcode;
+    response.sequence = request.sequence;
+    response.zone = request.zone;
+
+    const ControlOpcode opcode = static_cast<ControlOpcode>(request.opcode);
+    if (opcode == ControlOpcode::ZoneCount) {
+        response.zone = static_cast<std::uint32_t>(published.size());
+        return;
+    }
+    if (opcode < ControlOpcode::ReadState || opcode > ControlOpcode::SetLouver) {
+        response.status = static_cast<std::uint8_t>(ControlStatus::UnknownOpcode);
+        return;
+    }
+    if (request.zone >= published.size()) {
+        response.status = static_cast<std::uint8_t>(ControlStatus::BadZone);
+        return;
+    }
+    fillState(published[request.zone], response);
+    if (opcode == ControlOpcode::ReadState) {
+        return;
+    }
+
+    ControlCommand command;
+    command.opcode = opcode;
+    command.zone = request.zone;
+    bool valid = true;
+    switch (opcode) {
+    case ControlOpcode::SetSetpoint:
+        command.temperature = request.a / 100.0;
+        command.humidity = request.b / 100.0;
+        valid = isValidSetpoint(command.temperature, command.humidity);
+        break;
+    case ControlOpcode::SetAC:
+        command.acAction = static_cast<ControlACAction>(request.a);
+        valid = request.a >= static_cast<std::int32_t>(ControlACAction::Off) &&
+                request.a <= static_cast<std::int32_t>(ControlACAction::Toggle);
+        break;
+    default: // SetLouver
+        command.pan = static_cast<std::int16_t>(request.a);
+        command.tilt = static_cast<std::int16_t>(request.b);
+        valid = isValidLouver(request.a, request.b);
+        break;
+    }
+    if (!valid) {
+        response.status = static_cast<std::uint8_t>(ControlStatus::BadValue);
+        return;
+    }
+    if (accepted.size() >= acceptBudget) {
+        response.status = static_cast<std::uint8_t>(ControlStatus::Busy);
+        return;
+    }
+    accepted.push_back(command);
+}
+
+#ifdef __linux__
+
+bool ControlServer::listenUnix(const std::string &path) {
+    sockaddr_un address;
+    if (listenFd >= 0 || !fillUnixAddress(path, address)) {
+        return false;
+    }
+    // Удаляем только сокет от прошлого запуска; обычный файл по ошибочному пути не трогаем
+    struct stat status;
+    if (::lstat(path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode) || ::unlink(path.c_str()) != 0) {
+            return false;
+        }
+    } else if (errno != ENOENT) {
+        return false;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (::bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    unixPath = path;
+    return startListening(fd);
+}
+
+bool ControlServer::listenTcp(std::uint16_t port) {
+    if (listenFd >= 0) {
+        return false;
+    }
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    const int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = loopbackAddress(port);
+    if (::bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+    return startListening(fd);
+}
+
+bool ControlServer::startListening(int fd) {
+    listenFd = fd;
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (::listen(listenFd, SOMAXCONN) != 0 || epollFd < 0 || wakeFd < 0) {
+        stop();
+        return false;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    worker = std::thread(&ControlServer::run, this);
+    return true;
+}
+
+void ControlServer::stop() {
+    if (worker.joinable()) {
+        const std::uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+        worker.join();
+    }
+    for (int *fd : {&listenFd, &epollFd, &wakeFd}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!unixPath.empty()) {
+        ::unlink(unixPath.c_str());
+        unixPath.clear();
+    }
+    boundPort = 0;
+}
+
+void ControlServer::run() {
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    epoll_event events[kMaxEvents];
+
+    for (;;) {
+        const int ready = ::epoll_wait(epollFd, events, kMaxEvents, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        bool stopping = false;
+        {
+            // Запас очереди оцениваем один раз за проход: drain() его только увеличивает
+            std::lock_guard<std::mutex> lock(commandMutex);
+            acceptBudget = maxPending > pending.size() ? maxPending - pending.size() : 0;
+        }
+        accepted.clear();
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                stopping = true;
+            } else if (fd == listenFd) {
+                // Новые соединения регистрируются в epoll прямо здесь
+                for (;;) {
+                    const int client = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) {
+                        break;
+                    }
+                    const int noDelay = 1;
+                    ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // Для Unix-сокета игнорируется
+                    auto connection = std::make_unique<Connection>();
+                    connection->fd = client;
+                    epoll_event event = {};
+                    event.events = EPOLLIN | EPOLLRDHUP;
+                    event.data.fd = client;
+                    connection->events = event.events;
+                    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &event);
+                    connections.emplace(client, std::move(connection));
+                }
+                clients.store(connections.size(), std::memory_order_relaxed);
+            } else {
+                auto found = connections.find(fd);
+                if (found == connections.end()) {
+                    continue;
+                }
+                Connection &connection = *found->second;
+                bool open = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+                if (open && (events[i].events & EPOLLOUT) != 0) {
+                    open = flushOutput(connection) && !(connection.peerClosed && connection.output.empty());
+                }
+                if (open && (events[i].events & (EPOLLIN | EPOLLRDHUP)) != 0) {
+                    open = serviceClient(connection);
+                }
+                if (!open) {
+                    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+                    ::close(fd);
+                    connections.erase(found);
+                    clients.store(connections.size(), std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Изменения всего прохода уходят владельцу хранилища одним пакетом
+        if (!accepted.empty()) {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            pending.insert(pending.end(), accepted.begin(), accepted.end());
+        }
+        if (stopping) {
+            break;
+        }
+    }
+
+    for (auto &entry : connections) {
+        ::close(entry.first);
+    }
+    clients.store(0, std::memory_order_relaxed);
+}
+
+bool ControlServer::serviceClient(Connection &connection) {
+    unsigned char chunk[kReadChunk];
+    for (;;) {
+        const ssize_t received = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (received > 0) {
+            connection.input.insert(connection.input.end(), chunk, chunk + received);
+            if (static_cast<std::size_t>(received) < sizeof(chunk)) {
+                break;
+            }
+            continue;
+        }
+        if (received == 0) {
+            connection.peerClosed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+
+    const std::size_t frames = connection.input.size() / sizeof(ControlRequest);
+    if (frames > 0) {
+        const std::size_t offset = connection.output.size();
+        connection.output.resize(offset + frames * sizeof(ControlResponse));
+        {
+            // Один захват снимка на все запросы пакета
+            std::lock_guard<std::mutex> lock(snapshotMutex);
+            for (std::size_t i = 0; i < frames; ++i) {
+                ControlRequest request;
+                ControlResponse response;
+                std::memcpy(&request, connection.input.data() + i * sizeof(ControlRequest), sizeof(request));
+                handleRequest(request, response);
+                std::memcpy(connection.output.data() + offset + i * sizeof(ControlResponse), &response,
+                            sizeof(response));
+            }
+        }
+
+        connection.input.erase(connection.input.begin(),
+                               connection.input.begin() + frames * sizeof(ControlRequest));
+        requests.fetch_add(frames, std::memory_order_relaxed);
+    }
+
+    if (!flushOutput(connection)) {
+        return false;
+    }
+    // После shutdown(SHUT_WR) клиент ещё ждёт ответы: закрываем, только когда хвост ушёл
+    return !(connection.peerClosed && connection.output.empty());
+}
+
+bool ControlServer::flushOutput(Connection &connection) {
+    while (connection.outputOffset < connection.output.size()) {
+        const ssize_t written = ::send(connection.fd, connection.output.data() + connection.outputOffset,
+                                       connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;
+        }
+        connection.outputOffset += static_cast<std::size_t>(written);
+    }
+    if (connection.outputOffset == connection.output.size()) {
+        connection.output.clear();
+        connection.outputOffset = 0;
+    }
+
+    // Пока клиент не забирает ответы, ждём и EPOLLOUT; при большом хвосте или после
+    // закрытия записи клиентом перестаём читать
+    const bool blocked = !connection.output.empty();
+    const bool backlogged = connection.output.size() - connection.outputOffset > kMaxOutputBacklog;
+    const bool readable = !backlogged && !connection.peerClosed;
+    const std::uint32_t events = (readable ? EPOLLIN | EPOLLRDHUP : 0u) | (blocked ? EPOLLOUT : 0u);
+    if (events != connection.events) {
+        epoll_event event = {};
+        event.events = events;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+    return true;
+}
+
+#else // Сервер на epoll есть только в Linux
+
+bool ControlServer::listenUnix(const std::string &) {
+    return false;
+}
+
+bool ControlServer::listenTcp(std::uint16_t) {
+    return false;
+}
+
+bool ControlServer::startListening(int) {
+    return false;
+}
+
+void ControlServer::stop() {
+}
+
+void ControlServer::run() {
+}
+
+bool ControlServer::serviceClient(Connection &) {
+    return false;
+}
+
+bool ControlServer::flushOutput(Connection &) {
+    return false;
+}
+
+#endif
+
+#ifndef _WIN32
+
+ControlClient::~ControlClient() {
+    close();
+}
+
+bool ControlClient::connectUnix(const std::string &path) {
+    sockaddr_un address;
+    if (!fillUnixAddress(path, address)) {
+        return false;
+    }
+    close();
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ControlClient::connectTcp(std::uint16_t port) {
+    close();
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    const sockaddr_in address = loopbackAddress(port);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    const int noDelay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return true;
+}
+
+void ControlClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool ControlClient::call(const ControlRequest *requests, std::size_t count, ControlResponse *responses) {
+    // Частями, чтобы ответы не упирались в предел хвоста сервера, пока клиент ещё пишет
+    constexpr std::size_t kChunk = 4096;
+    for (std::size_t done = 0; done < count; done += kChunk) {
+        const std::size_t part = std::min(kChunk, count - done);
+        if (fd < 0 || !sendAll(fd, requests + done, part * sizeof(ControlRequest)) ||
+            !receiveAll(fd, responses + done, part * sizeof(ControlResponse))) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+#else
+
+ControlClient::~ControlClient() {
+}
+
+bool ControlClient::connectUnix(const std::string &) {
+    return false;
+}
+
+bool ControlClient::connectTcp(std::uint16_t) {
+    return false;
+}
+
+void ControlClient::close() {
+}
+
+bool ControlClient::call(const ControlRequest *, std::size_t, ControlResponse *) {
+    return false;
+}
+
+#endif
+
+bool ControlClient::readState(ZoneStore::ZoneId zone, ControlResponse &response) {
+    const ControlRequest request = {static_cast<std::uint8_t>(ControlOpcode::ReadState), 0, nextSequence++, zone, 0, 0};
+    return call(request, response);
+}
+
+bool ControlClient::setSetpoint(ZoneStore::ZoneId zone, double temperature, double humidity,
+                                ControlResponse &response) {
+    const ControlRequest request = {static_cast<std::uint8_t>(ControlOpcode::SetSetpoint), 0, nextSequence++, zone,
+                                    toFixed<std::int32_t>(temperature, 100.0), toFixed<std::int32_t>(humidity, 100.0)};
+    return call(request, response);
+}
+
+bool ControlClient::setAC(ZoneStore::ZoneId zone, ControlACAction action, ControlResponse &response) {
+    const ControlRequest request = {static_cast<std::uint8_t>(ControlOpcode::SetAC), 0, nextSequence++, zone,
+                                    static_cast<std::int32_t>(action), 0};
+    return call(request, response);
+}
+
+bool ControlClient::setLouver(ZoneStore::ZoneId zone, int pan, int tilt, ControlResponse &response) {
+    const ControlRequest request = {static_cast<std::uint8_t>(ControlOpcode::SetLouver), 0, nextSequence++, zone,
+                                    pan, tilt};
+    return call(request, response);
+}
+
+} // namespace hvac
@@ -0,0 +1,196 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include "zonestore.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Код запроса протокола управления.
+ */
+enum class ControlOpcode : std::uint8_t {
+    ReadState = 1,   // Состояние зоны
+    SetSetpoint = 2, // a — температура в сотых °C, b — влажность в сотых %
+    SetAC = 3,       // a — ControlACAction
+    SetLouver = 4,   // a — горизонтальный угол, b — вертикальный угол, градусы
+    ZoneCount = 5    // Число зон (в поле zone ответа)
+};
+
+/**
+ * @brief Действие с кондиционером в запросе SetAC.
+ */
+enum class ControlACAction : std::int32_t {
+    Off = 0,
+    On = 1,
+    Toggle = 2
+};
+
+/**
+ * @brief Результат обработки запроса.
+ */
+enum class ControlStatus : std::uint8_t {
+    Ok = 0,
+    BadZone = 1,       // Нет такой зоны
+    BadValue = 2,      // Значение вне допустимого диапазона
+    UnknownOpcode = 3,
+    Busy = 4           // Очередь изменений переполнена, запрос отброшен
+};
+
+/**
+ * @brief Запрос протокола управления: 16 байт, little-endian.
+ *
+ * Клиент может слать запросы подряд, не дожидаясь ответов; ответы приходят
+ * в том же порядке и несут тот же sequence.
+ */
+struct ControlRequest {
+    std::uint8_t opcode;    // ControlOpcode
+    std::uint8_t reserved;
+    std::uint16_t sequence; // Возвращается в ответе без изменений
+    std::uint32_t zone;
+    std::int32_t a;         // Смысл зависит от opcode
+    std::int32_t b;
+};
+static_assert(sizeof(ControlRequest) == 16, "ControlRequest must stay 16 bytes");
+
+/**
+ * @brief Ответ протокола управления: 32 байта, little-endian.
+ *
+ * Состояние зоны берётся из последнего опубликованного снимка: изменения,
+ * принятые запросами Set*, видны в нём после ближайшего применения пакета.
+ */
+struct ControlResponse {
+    std::uint8_t opcode;             // ControlOpcode запроса
+    std::uint8_t status;             // ControlStatus
+    std::uint16_t sequence;
+    std::uint32_t zone;
+    std::int32_t temperature;        // Сотые °C
+    std::int32_t humidity;           // Сотые %
+    std::int32_t pressure;           // Десятые Pa
+    std::int16_t setpointTemperature; // Сотые °C
+    std::uint16_t setpointHumidity;  // Сотые %
+    std::uint8_t acOn;
+    std::uint8_t reserved;
+    std::int16_t louverPan;
+    std::int16_t louverTilt;
+    std::uint16_t reserved2;
+};
+static_assert(sizeof(ControlResponse) == 32, "ControlResponse must stay 32 bytes");
+
+/**
+ * @brief Принятое сервером изменение состояния в базовых единицах.
+ */
+struct ControlCommand {
+    ControlOpcode opcode = ControlOpcode::SetSetpoint;
+    ZoneStore::ZoneId zone = 0;
+    double temperature = 0;   // SetSetpoint, °C
+    double humidity = 0;      // SetSetpoint, %
+    ControlACAction acAction = ControlACAction::Off; // SetAC
+    std::int16_t pan = 0;     // SetLouver
+    std::int16_t tilt = 0;    // SetLouver
+};
+
+/**
+ * @class ControlServer
+ * @brief Встроенный сервер протокола управления на Unix-сокете или localhost TCP.
+ *
+ * Собственный поток с циклом epoll обслуживает любое число клиентов. Чтение
+ * отвечается из снимка, который поток владельца хранилища обновляет через
+ * publish(); изменения копятся пакетом и забираются тем же потоком через
+ * drain(), поэтому ZoneStore по-прежнему трогает только один поток.
+ * Реализация есть только для Linux; на других системах listen*() возвращают false.
+ */
+class ControlServer {
+public:
+    explicit ControlServer(std::size_t maxPendingCommands = 1 << 16);
+    ~ControlServer();
+
+    ControlServer(const ControlServer &) = delete;
+    ControlServer &operator=(const ControlServer &) = delete;
+
+    bool listenUnix(const std::string &path); // Прежний сокет по пути удаляется; false, если там другой файл
+    bool listenTcp(std::uint16_t port);       // Только 127.0.0.1; 0 — выбрать свободный порт
+    std::uint16_t tcpPort() const { return boundPort; }
+    void stop();
+
+    void publish(const ZoneStore &store);                // Снимок для ответов на чтение
+    std::size_t drain(std::vector<ControlCommand> &out); // Забрать накопленные изменения (out очищается)
+    std::size_t applyPending(ZoneStore &store);          // drain() и применение без GUI
+
+    std::uint64_t requestCount() const { return requests.load(std::memory_order_relaxed); }
+    std::size_t clientCount() const { return clients.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection;
+
+    bool startListening(int listenFd);
+    void run();
+    bool serviceClient(Connection &connection); // false — соединение закрыто
+    bool flushOutput(Connection &connection);
+    void handleRequest(const ControlRequest &request, ControlResponse &response);
+
+    std::size_t maxPending;
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::size_t> clients{0};
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1; // eventfd для остановки цикла
+    std::string unixPath;
+    std::uint16_t boundPort = 0;
+    std::thread worker;
+
+    std::mutex snapshotMutex;
+    std::vector<ZoneSnapshot> published; // Последний снимок зон
+
+    std::mutex commandMutex;
+    std::vector<ControlCommand> pending;  // Изменения, ещё не забранные drain()
+    // Только поток сервера: изменения текущего прохода цикла и свободное место в очереди
+    std::vector<ControlCommand> accepted;
+    std::size_t acceptBudget = 0;
+};
+
+// Применение одного изменения к хранилищу (переключение кондиционера — от текущего статуса)
+void applyControlCommand(ZoneStore &store, const ControlCommand &command);
+
+/**
+ * @class ControlClient
+ * @brief Блокирующий клиент протокола для скриптов и проверки сервера.
+ */
+class ControlClient {
+public:
+    ControlClient() = default;
+    ~ControlClient();
+
+    ControlClient(const ControlClient &) = delete;
+    ControlClient &operator=(const ControlClient &) = delete;
+
+    bool connectUnix(const std::string &path);
+    bool connectTcp(std::uint16_t port);
+    void close();
+    bool isConnected() const { return fd >= 0; }
+
+    // Отправляет count запросов одним пакетом и ждёт все ответы
+    bool call(const ControlRequest *requests, std::size_t count, ControlResponse *responses);
+    bool call(const ControlRequest &request, ControlResponse &response) { return call(&request, 1, &response); }
+
+    bool readState(ZoneStore::ZoneId zone, ControlResponse &response);
+    bool setSetpoint(ZoneStore::ZoneId zone, double temperature, double humidity, ControlResponse &response);
+    bool setAC(ZoneStore::ZoneId zone, ControlACAction action, ControlResponse &response);
+    bool setLouver(ZoneStore::ZoneId zone, int pan, int tilt, ControlResponse &response);
+
+private:
+    int fd = -1;
+    std::uint16_t nextSequence = 0;
+};
+
+} // namespace hvac
+
+#endif // CONTROLSERVER_H
@@ -0,0 +1,222 @@
+#include "historyring.h"
+
+#include <algorithm>
+
+namespace hvac {
+
+HistoryRing::HistoryRing(std::size_t capacity)
+    : values(std::max<std::size_t>(capacity, 1), 0.0) {}
+
+void HistoryRing::push(double value) {
+    if (count < values.size()) {
+        values[physical(count)] = value;
+        ++count;
+        return;
+    }
+    // Заполнено: перезаписываем самое старое значение
+    values[start] = value;
+    start = start + 1 == values.size() ? 0 : start + 1;
+}
+
+void HistoryRing::clear() {
+    start = 0;
+    count = 0;
+}
+
+void HistoryRing::segments(const double *&first, std::size_t &firstSize,
+                           const double *&second, std::size_t &secondSize) const {
+    first = values.data() + start;
+    firstSize = std::min(count, values.size() - start);
+    second = values.data();
+    secondSize = count - firstSize;
+}
+
+std::size_t decimateMinMax(const HistoryRing &history, std::size_t buckets, TrendPoint *out,
+                           double &minValue, double &maxValue) {
+    const std::size_t total = history.size();
+    minValue = 0;
+    maxValue = 0;
+    if (total == 0 || buckets == 0) {
+        return 0;
+    }
+
+    const double *segment[2];
+    std::size_t segmentSize[2];
+    history.segments(segment[0], segmentSize[0], segment[1], segmentSize[1]);
+    auto valueAt = [&](std::size_t index) {
+        return index < segmentSize[0] ? segment[0][index] : segment[1][index - segmentSize[0]];
+    };
+
+    // Истории меньше, чем корзин: рисуем все значения как есть
+    if (total <= 2 * buckets) {
+        minValue = maxValue = valueAt(0);
+        for (std::size_t i = 0; i < total; ++i) {
+            const double value = valueAt(i);
+            out[i] = {static_cast<double>(i), value};
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+        }
+        return total;
+    }
+
+    std::size_t written = 0;
+    minValue = maxValue = valueAt(0);
+    for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+        const std::size_t begin = bucket * total / buckets;
+        const std::size_t end = (bucket + 1) * total / buckets;
+        std::size_t minIndex = begin;
+        std::size_t maxIndex = begin;
+        double low = valueAt(begin);
+        double high = low;
+        for (std::size_t i = begin + 1; i < end; ++i) {
+            const double value = valueAt(i);
+            if (value < low) {
+                low = value;
+                minIndex = i;
+            }
+            if (value > high) {
+                high = value;
+                maxIndex = i;
+            }
+        }
+        minValue = std::min(minValue, low);
+        maxValue = std::max(maxValue, high);
+
+        // Сохраняем порядок появления, чтобы линия не шла назад по времени
+        const std::size_t firstIndex = std::min(minIndex, maxIndex);
+        const std::size_t secondIndex = std::max(minIndex, maxIndex);
+        out[written++] = {static_cast<double>(firstIndex), valueAt(firstIndex)};
+        if (secondIndex != firstIndex) {
+            out[written++] = {static_cast<double>(secondIndex), valueAt(secondIndex)};
+        }
+    }
+    return written;
+}
+
+void MinMaxBuckets::reset(const HistoryRing &history, std::size_t buckets) {
+    targetBuckets = std::max<std::size_t>(buckets, 1);
+    bucketList.clear();
+    const std::size_t total = history.size();
+    oldestSequence = 0;
+    nextSequence = 0;
+    width = 1;
+    while ((total + width - 1) / width > targetBuckets) {
+        width *= 2;
+    }
+
+    const double *segment[2];
+    std::size_t segmentSize[2];
+    history.segments(segment[0], segmentSize[0], segment[1], segmentSize[1]);
+    for (int part = 0; part < 2; ++part) {
+        for (std::size_t i = 0; i < segmentSize[part]; ++i) {
+            append(nextSequence++, segment[part][i]);
+        }
+    }
+}
+
+void MinMaxBuckets::push(const HistoryRing &history) {
+    if (history.size() == 0) {
+        return;
+    }
+    append(nextSequence++, history.at(history.size() - 1));
+    dropEvicted(history);
+    if (bucketList.size() > targetBuckets) {
+        mergePairs();
+    }
+}
+
+void MinMaxBuckets::append(std::uint64_t sequence, double value) {
+    const std::uint64_t number = sequence / width;
+    if (bucketList.empty() || bucketList.back().number != number) {
+        bucketList.push_back(Bucket{number, value, value, sequence, sequence});
+        return;
+    }
+    Bucket &bucket = bucketList.back();
+    if (value < bucket.minValue) {
+        bucket.minValue = value;
+        bucket.minSequence = sequence;
+    }
+    if (value > bucket.maxValue) {
+        bucket.maxValue = value;
+        bucket.maxSequence = sequence;
+    }
+}
+
+void MinMaxBuckets::dropEvicted(const HistoryRing &history) {
+    oldestSequence = nextSequence - history.size();
+    const std::uint64_t oldest = oldestSequence;
+    while (!bucketList.empty() && (bucketList.front().number + 1) * width <= oldest) {
+        bucketList.pop_front();
+    }
+    if (bucketList.empty()) {
+        return;
+    }
+    Bucket &front = bucketList.front();
+    if (front.minSequence >= oldest && front.maxSequence >= oldest) {
+        return;
+    }
+    // Вытеснен экстремум первой корзины: пересчитываем её оставшуюся часть (не больше width значений)
+    const std::uint64_t end = std::min((front.number + 1) * width, nextSequence);
+    front.minValue = front.maxValue = history.at(0);
+    front.minSequence = front.maxSequence = oldest;
+    for (std::uint64_t sequence = oldest + 1; sequence < end; ++sequence) {
+        const double value = history.at(static_cast<std::size_t>(sequence - oldest));
+        if (value < front.minValue) {
+            front.minValue = value;
+            front.minSequence = sequence;
+        }
+        if (value > front.maxValue) {
+            front.maxValue = value;
+            front.maxSequence = sequence;
+        }
+    }
+}
+
+void MinMaxBuckets::mergePairs() {
+    width *= 2;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < bucketList.size(); ++i) {
+        Bucket bucket = bucketList[i];
+        bucket.number /= 2;
+        if (kept > 0 && bucketList[kept - 1].number == bucket.number) {
+            Bucket &merged = bucketList[kept - 1];
+            if (bucket.minValue < merged.minValue) {
+                merged.minValue = bucket.minValue;
+                merged.minSequence = bucket.minSequence;
+            }
+            if (bucket.maxValue > merged.maxValue) {
+                merged.maxValue = bucket.maxValue;
+                merged.maxSequence = bucket.maxSequence;
+            }
+        } else {
+            bucketList[kept++] = bucket;
+        }
+    }
+    bucketList.resize(kept);
+}
+
+std::size_t MinMaxBuckets::points(TrendPoint *out, double &minValue, double &maxValue) const {
+    minValue = 0;
+    maxValue = 0;
+    if (bucketList.empty()) {
+        return 0;
+    }
+    const std::uint64_t oldest = oldestSequence;
+    std::size_t written = 0;
+    minValue = bucketList.front().minValue;
+    maxValue = bucketList.front().maxValue;
+    for (const Bucket &bucket : bucketList) {
+        minValue = std::min(minValue, bucket.minValue);
+        maxValue = std::max(maxValue, bucket.maxValue);
+        const bool minFirst = bucket.minSequence <= bucket.maxSequence;
+        const std::uint64_t firstSequence = minFirst ? bucket.minSequence : bucket.maxSequence;
+        out[written++] = {static_cast<double>(firstSequence - oldest), minFirst ? bucket.minValue : bucket.maxValue};
+        if (bucket.minSequence != bucket.maxSequence) {
+            const std::uint64_t secondSequence = minFirst ? bucket.maxSequence : bucket.minSequence;
+            out[written++] = {static_cast<double>(secondSequence - oldest), minFirst ? bucket.maxValue : bucket.minValue};
+        }
+    }
+    return written;
+}
+
+} // namespace hvac
@@ -0,0 +1,106 @@
+#ifndef HISTORYRING_H
+#define HISTORYRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @class HistoryRing
+ * @brief История одного показания фиксированной ёмкости.
+ *
+ * Память выделяется один раз в конструкторе; при заполнении новые значения
+ * вытесняют самые старые. Индекс 0 — самое старое значение.
+ */
+class HistoryRing {
+public:
+    explicit HistoryRing(std::size_t capacity);
+
+    void push(double value);
+    void clear();
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return values.size(); }
+    double at(std::size_t index) const { return values[physical(index)]; }
+
+    // Непрерывные куски истории в хронологическом порядке (второй может быть пустым)
+    void segments(const double *&first, std::size_t &firstSize,
+                  const double *&second, std::size_t &secondSize) const;
+
+private:
+    std::size_t physical(std::size_t index) const {
+        const std::size_t position = start + index;
+        return position >= values.size() ? position - values.size() : position;
+    }
+
+    std::vector<double> values;
+    std::size_t start = 0; // Позиция самого старого значения
+    std::size_t count = 0;
+};
+
+/**
+ * @brief Точка прореженного ряда: номер значения в истории и само значение.
+ */
+struct TrendPoint {
+    double index;
+    double value;
+};
+
+/**
+ * @brief Прореживание min/max: история делится на buckets корзин, из каждой
+ * берутся минимум и максимум в порядке появления.
+ *
+ * Пики не теряются, а число точек не превышает 2 * buckets независимо от
+ * длины истории. out должен вмещать 2 * buckets точек. В minValue/maxValue
+ * возвращается диапазон значений для масштабирования оси. Возвращает число точек.
+ */
+std::size_t decimateMinMax(const HistoryRing &history, std::size_t buckets, TrendPoint *out,
+                           double &minValue, double &maxValue);
+
+/**
+ * @class MinMaxBuckets
+ * @brief Инкрементальное прореживание min/max одной истории для живого графика.
+ *
+ * Корзины выровнены по абсолютному номеру значения и имеют ширину 2^k, так что
+ * новое значение обновляет только последнюю корзину, вытесненное — только
+ * первую. Когда корзин становится больше заданного числа, соседние пары
+ * сливаются (ширина удваивается). Полный пересчёт нужен лишь при смене числа
+ * корзин (ширины окна) или очистке истории.
+ */
+class MinMaxBuckets {
+public:
+    void reset(const HistoryRing &history, std::size_t buckets); // Пересчёт по всей истории
+    void push(const HistoryRing &history);                       // После history.push()
+
+    std::size_t buckets() const { return targetBuckets; }
+
+    // Точки в порядке появления (индекс 0 — самое старое значение истории);
+    // out должен вмещать 2 * buckets() точек. Возвращает число точек.
+    std::size_t points(TrendPoint *out, double &minValue, double &maxValue) const;
+
+private:
+    struct Bucket {
+        std::uint64_t number; // Абсолютный номер корзины: первое значение / width
+        double minValue;
+        double maxValue;
+        std::uint64_t minSequence; // Абсолютные номера значений
+        std::uint64_t maxSequence;
+    };
+
+    void append(std::uint64_t sequence, double value);
+    void dropEvicted(const HistoryRing &history);
+    void mergePairs();
+
+    std::deque<Bucket> bucketList;
+    std::uint64_t oldestSequence = 0; // Номер самого старого значения истории
+    std::uint64_t nextSequence = 0;   // Номер следующего значения
+    std::uint64_t width = 1;        // Значений в корзине
+    std::size_t targetBuckets = 1;
+};
+
+} // namespace hvac
+
+#endif // HISTORYRING_H
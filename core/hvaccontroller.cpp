@@ -0,0 +1,47 @@
+#include "hvaccontroller.h"
+
+#include "instrumentation.h"
+
+#include <cmath>
+
+namespace hvac {
+
+Controller::Controller(ZoneStore &store, ZoneStore::ZoneId zone)
+    : store(&store), zoneId(zone) {}
+
+void Controller::selectZone(ZoneStore::ZoneId zone) {
+    zoneId = zone;
+}
+
+void Controller::update(double temperature, int humidity, double pressure) {
+    store->setReading(zoneId,
+                      convertTemperature(temperature, unitTemperature, TemperatureUnit::Celsius),
+                      humidity,
+                      convertPressure(pressure, unitPressure, PressureUnit::Pascal));
+}
+
+void Controller::setSetpoint(double temperature, int humidity) {
+    store->setSetpoint(zoneId, convertTemperature(temperature, unitTemperature, TemperatureUnit::Celsius),
+                       humidity);
+}
+
+bool Controller::toggleAC() {
+    const bool acOn = !store->acStatus(zoneId);
+    store->setACStatus(zoneId, acOn);
+    return acOn;
+}
+
+double Controller::temperature() const {
+    HVAC_SCOPED_TIMER("convertTemperature"); // Перевод в единицы отображения на каждом обновлении меток
+    return convertTemperature(store->temperature(zoneId), TemperatureUnit::Celsius, unitTemperature);
+}
+
+int Controller::humidity() const {
+    return static_cast<int>(std::lround(store->humidity(zoneId)));
+}
+
+double Controller::pressure() const {
+    return convertPressure(store->pressure(zoneId), PressureUnit::Pascal, unitPressure);
+}
+
+} // namespace hvac
@@ -0,0 +1,46 @@
+#ifndef HVACCONTROLLER_H
+#define HVACCONTROLLER_H
+
+#include "units.h"
+#include "zonestore.h"
+
+namespace hvac {
+
+/**
+ * @class Controller
+ * @brief Представление одной выбранной зоны ZoneStore в единицах отображения.
+ *
+ * Само состояние зоны живёт в ZoneStore; контроллер хранит только номер
+ * зоны и выбранные единицы, пересчитывая значения при чтении и записи.
+ */
+class Controller {
+public:
+    explicit Controller(ZoneStore &store, ZoneStore::ZoneId zone = 0);
+
+    void selectZone(ZoneStore::ZoneId zone); // Переключение на другую зону
+    ZoneStore::ZoneId zone() const { return zoneId; }
+
+    void update(double temperature, int humidity, double pressure);  // Новые показания в единицах отображения
+    void setSetpoint(double temperature, int humidity);              // Уставки в единицах отображения
+    bool toggleAC();                                                 // Возвращает новый статус
+
+    void setTemperatureUnit(TemperatureUnit unit) { unitTemperature = unit; }
+    void setPressureUnit(PressureUnit unit) { unitPressure = unit; }
+
+    double temperature() const; // Температура в единицах отображения
+    int humidity() const;
+    double pressure() const;    // Давление в единицах отображения
+    bool acStatus() const { return store->acStatus(zoneId); }
+    TemperatureUnit temperatureUnit() const { return unitTemperature; }
+    PressureUnit pressureUnit() const { return unitPressure; }
+
+private:
+    ZoneStore *store;                                           // Хранилище зон
+    ZoneStore::ZoneId zoneId;                                   // Выбранная зона
+    TemperatureUnit unitTemperature = TemperatureUnit::Celsius; // Единицы измерения температуры
+    PressureUnit unitPressure = PressureUnit::Pascal;           // Единицы измерения давления
+};
+
+} // namespace hvac
+
+#endif // HVACCONTROLLER_H
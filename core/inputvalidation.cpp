@@ -0,0 +1,477 @@
+#include "inputvalidation.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace hvac {
+
+namespace {
+constexpr char kSetpointMagic[4] = {'H', 'V', 'S', 'T'};
+constexpr std::uint16_t kSetpointVersion = 1;
+
+/**
+ * @brief Заголовок двоичной таблицы уставок (16 байт), за ним count записей.
+ */
+struct SetpointFileHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t recordSize;
+    std::uint32_t count;
+    std::uint32_t checksum; // FNV-1a по записям
+};
+static_assert(sizeof(SetpointFileHeader) == 16, "SetpointFileHeader must stay 16 bytes");
+
+struct SetpointRecord {
+    std::uint32_t zone;
+    float temperature;
+    float humidity;
+};
+static_assert(sizeof(SetpointRecord) == 12, "SetpointRecord must stay 12 bytes");
+
+// Биты failedMask
+constexpr std::uint8_t kZoneFailed = 1;
+constexpr std::uint8_t kTemperatureFailed = 2;
+constexpr std::uint8_t kHumidityFailed = 4;
+
+std::uint32_t checksumOf(const unsigned char *data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+bool isSeparator(char c) {
+    return c == ',' || c == ';' || c == '\t';
+}
+
+// Убирает пробелы по краям и '+' перед числом (from_chars его не принимает)
+void trimNumber(const char *&begin, const char *&end) {
+    while (begin < end && isBlank(*begin)) {
+        ++begin;
+    }
+    while (end > begin && isBlank(end[-1])) {
+        --end;
+    }
+    if (end - begin > 1 && *begin == '+' && begin[1] != '-') {
+        ++begin;
+    }
+}
+} // namespace
+
+ValueRange rangeOf(InputField field) {
+    switch (field) {
+    case InputField::Zone:
+        return {0.0, static_cast<double>(std::numeric_limits<ZoneStore::ZoneId>::max())};
+    case InputField::Temperature:
+        return {-50.0, 70.0};
+    case InputField::Humidity:
+        return {0.0, 100.0};
+    case InputField::Pressure:
+        return {0.0, std::numeric_limits<double>::max()};
+    case InputField::LouverPan:
+        return {0.0, 180.0};
+    case InputField::LouverTilt:
+        return {0.0, 90.0};
+    }
+    return {0.0, 0.0};
+}
+
+InputError parseNumber(const char *begin, const char *end, double &value) {
+    trimNumber(begin, end);
+    if (begin == end) {
+        return InputError::Empty;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const std::from_chars_result result = std::from_chars(begin, end, value);
+    if (result.ec == std::errc::invalid_argument) {
+        return InputError::NotANumber;
+    }
+    if (result.ec == std::errc::result_out_of_range) {
+        return InputError::OutOfRange;
+    }
+    const char *parsed = result.ptr;
+#else
+    // Стандартная библиотека без from_chars для double: strtod по копии (точка как разделитель в локали "C")
+    char buffer[64];
+    const std::size_t length = static_cast<std::size_t>(end - begin);
+    if (length >= sizeof(buffer)) {
+        return InputError::NotANumber;
+    }
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char *stop = nullptr;
+    value = std::strtod(buffer, &stop);
+    if (stop == buffer) {
+        return InputError::NotANumber;
+    }
+    const char *parsed = begin + (stop - buffer);
+#endif
+    if (parsed != end) {
+        return InputError::TrailingCharacters;
+    }
+    return std::isfinite(value) ? InputError::None : InputError::NotANumber;
+}
+
+InputError parseInteger(const char *begin, const char *end, long long &value) {
+    trimNumber(begin, end);
+    if (begin == end) {
+        return InputError::Empty;
+    }
+    const std::from_chars_result result = std::from_chars(begin, end, value);
+    if (result.ec == std::errc::invalid_argument) {
+        return InputError::NotANumber;
+    }
+    if (result.ec == std::errc::result_out_of_range) {
+        return InputError::OutOfRange;
+    }
+    if (result.ptr != end) {
+        // "45.5" — число, но не целое
+        double number;
+        return parseNumber(begin, end, number) == InputError::None ? InputError::NotAnInteger
+                                                                   : InputError::TrailingCharacters;
+    }
+    return InputError::None;
+}
+
+InputError validateValue(InputField field, double value) {
+    if (!std::isfinite(value)) {
+        return InputError::NotANumber;
+    }
+    return rangeOf(field).contains(value) ? InputError::None : InputError::OutOfRange;
+}
+
+InputError parseField(InputField field, const char *begin, const char *end, double &value) {
+    const InputError error = parseNumber(begin, end, value);
+    return error != InputError::None ? error : validateValue(field, value);
+}
+
+bool isValidSetpoint(double temperature, double humidity) {
+    return rangeOf(InputField::Temperature).contains(temperature) && rangeOf(InputField::Humidity).contains(humidity);
+}
+
+bool isValidLouver(int pan, int tilt) {
+    return rangeOf(InputField::LouverPan).contains(pan) && rangeOf(InputField::LouverTilt).contains(tilt);
+}
+
+const char *inputFieldName(InputField field) {
+    switch (field) {
+    case InputField::Zone:
+        return "zone";
+    case InputField::Temperature:
+        return "temperature";
+    case InputField::Humidity:
+        return "humidity";
+    case InputField::Pressure:
+        return "pressure";
+    case InputField::LouverPan:
+        return "louver pan";
+    case InputField::LouverTilt:
+        return "louver tilt";
+    }
+    return "?";
+}
+
+const char *inputErrorMessage(InputError error) {
+    switch (error) {
+    case InputError::None:
+        return "нет ошибки";
+    case InputError::Empty:
+        return "пустое поле";
+    case InputError::NotANumber:
+        return "не число";
+    case InputError::NotAnInteger:
+        return "ожидается целое число";
+    case InputError::TrailingCharacters:
+        return "лишние символы после числа";
+    case InputError::OutOfRange:
+        return "вне допустимого диапазона";
+    case InputError::BadZone:
+        return "нет такой зоны";
+    case InputError::MissingField:
+        return "не хватает полей";
+    case InputError::ExtraField:
+        return "лишние поля";
+    }
+    return "?";
+}
+
+void ImportReport::clear() {
+    rows = 0;
+    accepted = 0;
+    rejected = 0;
+    issues.clear();
+}
+
+void ImportReport::reject(std::size_t row, InputField field, InputError error) {
+    ++rejected;
+    if (issues.size() < kMaxReportedIssues) {
+        issues.push_back(InputIssue{row, field, error});
+    }
+}
+
+SetpointImporter::SetpointImporter(std::size_t zoneCount)
+    : zoneCount(zoneCount) {
+}
+
+bool SetpointImporter::parseCsv(const char *data, std::size_t size, SetpointBatch &batch, ImportReport &report) {
+    report.clear();
+    batch.clear();
+    rowOf.clear();
+    parseIssues.clear();
+    parseRejected = 0;
+
+    const char *cursor = data;
+    const char *const dataEnd = data + size;
+    std::size_t line = 0;
+    bool firstDataLine = true;
+    while (cursor < dataEnd) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<std::size_t>(dataEnd - cursor)));
+        if (lineEnd == nullptr) {
+            lineEnd = dataEnd;
+        }
+        const char *const next = lineEnd < dataEnd ? lineEnd + 1 : dataEnd;
+        if (lineEnd > cursor && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        const char *start = cursor;
+        cursor = next;
+        ++line;
+        while (start < lineEnd && *start == ' ') {
+            ++start;
+        }
+        if (start == lineEnd || *start == '#') {
+            continue;
+        }
+
+        // Границы полей; четвёртое нужно только чтобы заметить лишние
+        const char *fieldBegin[3];
+        const char *fieldEnd[3];
+        std::size_t fieldCount = 0;
+        const char *field = start;
+        for (;;) {
+            const char *stop = field;
+            while (stop < lineEnd && !isSeparator(*stop)) {
+                ++stop;
+            }
+            if (fieldCount < 3) {
+                fieldBegin[fieldCount] = field;
+                fieldEnd[fieldCount] = stop;
+            }
+            ++fieldCount;
+            if (stop == lineEnd) {
+                break;
+            }
+            field = stop + 1;
+        }
+
+        long long zone = 0;
+        const InputError zoneError = parseInteger(fieldBegin[0], fieldEnd[0], zone);
+        if (firstDataLine && zoneError == InputError::NotANumber) {
+            firstDataLine = false; // Строка заголовка
+            continue;
+        }
+        firstDataLine = false;
+        ++report.rows;
+
+        if (fieldCount < 3) {
+            rejectParsed(line, fieldCount == 1 ? InputField::Temperature : InputField::Humidity, InputError::MissingField);
+            continue;
+        }
+        if (fieldCount > 3) {
+            rejectParsed(line, InputField::Humidity, InputError::ExtraField);
+            continue;
+        }
+        if (zoneError != InputError::None) {
+            rejectParsed(line, InputField::Zone, zoneError);
+            continue;
+        }
+        if (!rangeOf(InputField::Zone).contains(static_cast<double>(zone))) {
+            rejectParsed(line, InputField::Zone, InputError::BadZone);
+            continue;
+        }
+        double temperature = 0;
+        double humidity = 0;
+        InputError error = parseNumber(fieldBegin[1], fieldEnd[1], temperature);
+        if (error != InputError::None) {
+            rejectParsed(line, InputField::Temperature, error);
+            continue;
+        }
+        error = parseNumber(fieldBegin[2], fieldEnd[2], humidity);
+        if (error != InputError::None) {
+            rejectParsed(line, InputField::Humidity, error);
+            continue;
+        }
+        // Диапазоны проверяются потом одним проходом по столбцам
+        batch.zones.push_back(static_cast<ZoneStore::ZoneId>(zone));
+        batch.temperature.push_back(temperature);
+        batch.humidity.push_back(humidity);
+        rowOf.push_back(static_cast<std::uint32_t>(line));
+    }
+    validate(batch, report);
+    return true;
+}
+
+bool SetpointImporter::parseBinary(const void *data, std::size_t size, SetpointBatch &batch, ImportReport &report) {
+    report.clear();
+    batch.clear();
+    rowOf.clear();
+    parseIssues.clear();
+    parseRejected = 0;
+
+    SetpointFileHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, kSetpointMagic, sizeof(kSetpointMagic)) != 0 || header.version != kSetpointVersion ||
+        header.recordSize != sizeof(SetpointRecord) ||
+        size - sizeof(header) != static_cast<std::size_t>(header.count) * sizeof(SetpointRecord)) {
+        return false;
+    }
+    const unsigned char *records = bytes + sizeof(header);
+    if (checksumOf(records, size - sizeof(header)) != header.checksum) {
+        return false;
+    }
+
+    batch.zones.resize(header.count);
+    batch.temperature.resize(header.count);
+    batch.humidity.resize(header.count);
+    rowOf.resize(header.count);
+    for (std::size_t i = 0; i < header.count; ++i) {
+        SetpointRecord record;
+        std::memcpy(&record, records + i * sizeof(SetpointRecord), sizeof(record));
+        batch.zones[i] = record.zone;
+        batch.temperature[i] = record.temperature;
+        batch.humidity[i] = record.humidity;
+        rowOf[i] = static_cast<std::uint32_t>(i + 1);
+    }
+    report.rows = header.count;
+    validate(batch, report);
+    return true;
+}
+
+void SetpointImporter::rejectParsed(std::size_t row, InputField field, InputError error) {
+    // Ошибок разбора дальше первых kMaxReportedIssues в отчёт всё равно не попадёт
+    ++parseRejected;
+    if (parseIssues.size() < ImportReport::kMaxReportedIssues) {
+        parseIssues.push_back(InputIssue{row, field, error});
+    }
+}
+
+void SetpointImporter::validate(SetpointBatch &batch, ImportReport &report) {
+    const std::size_t count = batch.size();
+    const ValueRange temperatureRange = rangeOf(InputField::Temperature);
+    const ValueRange humidityRange = rangeOf(InputField::Humidity);
+    const ZoneStore::ZoneId *zones = batch.zones.data();
+    const double *temperature = batch.temperature.data();
+    const double *humidity = batch.humidity.data();
+
+    // Проход без ветвлений по столбцам: для каждой записи маска отказавших полей
+    failedMask.resize(count);
+    std::uint8_t *failed = failedMask.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        failed[i] = static_cast<std::uint8_t>((zones[i] >= zoneCount ? kZoneFailed : 0) |
+                                              (temperatureRange.contains(temperature[i]) ? 0 : kTemperatureFailed) |
+                                              (humidityRange.contains(humidity[i]) ? 0 : kHumidityFailed));
+    }
+
+    // Отклонённые записи удаляются из пакета с сохранением порядка; ошибки разбора
+    // вливаются по номерам строк, чтобы предел отчёта отсекал именно первые строки
+    std::size_t kept = 0;
+    std::size_t parsed = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        for (; parsed < parseIssues.size() && parseIssues[parsed].row < rowOf[i]; ++parsed) {
+            report.reject(parseIssues[parsed].row, parseIssues[parsed].field, parseIssues[parsed].error);
+        }
+        if (failed[i] == 0) {
+            batch.zones[kept] = batch.zones[i];
+            batch.temperature[kept] = batch.temperature[i];
+            batch.humidity[kept] = batch.humidity[i];
+            ++kept;
+        } else if ((failed[i] & kZoneFailed) != 0) {
+            report.reject(rowOf[i], InputField::Zone, InputError::BadZone);
+        } else if ((failed[i] & kTemperatureFailed) != 0) {
+            report.reject(rowOf[i], InputField::Temperature, validateValue(InputField::Temperature, temperature[i]));
+        } else {
+            report.reject(rowOf[i], InputField::Humidity, validateValue(InputField::Humidity, humidity[i]));
+        }
+    }
+    for (; parsed < parseIssues.size(); ++parsed) {
+        report.reject(parseIssues[parsed].row, parseIssues[parsed].field, parseIssues[parsed].error);
+    }
+    report.rejected += parseRejected - parseIssues.size(); // Не вошедшие в отчёт считаются
+    batch.zones.resize(kept);
+    batch.temperature.resize(kept);
+    batch.humidity.resize(kept);
+    report.accepted = kept;
+}
+
+bool SetpointImporter::importFile(const std::string &path, SetpointBatch &batch, ImportReport &report) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    // Файл читается целиком одним вызовом; буфер остаётся для следующего импорта
+    bool ok = std::fseek(file, 0, SEEK_END) == 0;
+    const long size = ok ? std::ftell(file) : -1;
+    ok = size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+    if (ok) {
+        fileBuffer.resize(static_cast<std::size_t>(size));
+        ok = std::fread(fileBuffer.data(), 1, fileBuffer.size(), file) == fileBuffer.size();
+    }
+    std::fclose(file);
+    if (!ok) {
+        return false;
+    }
+    if (fileBuffer.size() >= sizeof(kSetpointMagic) &&
+        std::memcmp(fileBuffer.data(), kSetpointMagic, sizeof(kSetpointMagic)) == 0) {
+        return parseBinary(fileBuffer.data(), fileBuffer.size(), batch, report);
+    }
+    return parseCsv(fileBuffer.data(), fileBuffer.size(), batch, report);
+}
+
+bool saveSetpointBinary(const std::string &path, const SetpointBatch &batch) {
+    std::vector<unsigned char> data(sizeof(SetpointFileHeader) + batch.size() * sizeof(SetpointRecord));
+    unsigned char *records = data.data() + sizeof(SetpointFileHeader);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        const SetpointRecord record{batch.zones[i], static_cast<float>(batch.temperature[i]),
+                                    static_cast<float>(batch.humidity[i])};
+        std::memcpy(records + i * sizeof(SetpointRecord), &record, sizeof(record));
+    }
+    SetpointFileHeader header = {};
+    std::memcpy(header.magic, kSetpointMagic, sizeof(kSetpointMagic));
+    header.version = kSetpointVersion;
+    header.recordSize = sizeof(SetpointRecord);
+    header.count = static_cast<std::uint32_t>(batch.size());
+    header.checksum = checksumOf(records, batch.size() * sizeof(SetpointRecord));
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    const std::string temporaryPath = path + ".tmp";
+    std::FILE *file = std::fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename на Windows не заменяет существующий файл
+#endif
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+} // namespace hvac
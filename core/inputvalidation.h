@@ -0,0 +1,128 @@
+#ifndef INPUTVALIDATION_H
+#define INPUTVALIDATION_H
+
+#include "zonestore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Проверяемое поле ввода.
+ */
+enum class InputField : std::uint8_t {
+    Zone,
+    Temperature, // °C
+    Humidity,    // %
+    Pressure,    // Pa
+    LouverPan,   // Градусы
+    LouverTilt
+};
+
+/**
+ * @brief Причина отказа при разборе или проверке значения.
+ */
+enum class InputError : std::uint8_t {
+    None,
+    Empty,              // Пустое поле
+    NotANumber,         // Не число (или inf/nan)
+    NotAnInteger,       // Ожидалось целое
+    TrailingCharacters, // После числа есть лишние символы
+    OutOfRange,         // Вне допустимого диапазона поля
+    BadZone,            // Нет такой зоны
+    MissingField,       // В строке меньше полей, чем нужно
+    ExtraField          // В строке больше полей, чем нужно
+};
+
+/**
+ * @brief Допустимый диапазон значения (границы включены; NaN не проходит).
+ */
+struct ValueRange {
+    double minimum;
+    double maximum;
+
+    bool contains(double value) const { return value >= minimum && value <= maximum; }
+};
+
+// Одни пределы для диалога настроек, протокола управления и импорта файлов
+ValueRange rangeOf(InputField field);
+
+// Разбор числа в формате "C" независимо от локали, без выделения памяти; пробелы по краям допускаются
+InputError parseNumber(const char *begin, const char *end, double &value);
+InputError parseInteger(const char *begin, const char *end, long long &value);
+// Разбор и проверка диапазона поля
+InputError parseField(InputField field, const char *begin, const char *end, double &value);
+InputError validateValue(InputField field, double value);
+
+bool isValidSetpoint(double temperature, double humidity);
+bool isValidLouver(int pan, int tilt);
+
+const char *inputFieldName(InputField field);    // Для журналов и отчётов: "temperature"
+const char *inputErrorMessage(InputError error); // Для окна: "вне допустимого диапазона"
+
+/**
+ * @brief Одна отклонённая строка импорта.
+ */
+struct InputIssue {
+    std::size_t row = 0; // Номер строки файла (с 1) или записи двоичного файла (с 1)
+    InputField field = InputField::Zone;
+    InputError error = InputError::None;
+};
+
+/**
+ * @brief Итог импорта: сколько строк принято и почему отклонены остальные.
+ *
+ * Подробности хранятся не больше чем для kMaxReportedIssues отклонённых строк
+ * (по порядку строк), чтобы испорченный файл на миллион строк не раздувал отчёт.
+ */
+struct ImportReport {
+    static constexpr std::size_t kMaxReportedIssues = 1000;
+
+    std::size_t rows = 0;     // Строк с данными
+    std::size_t accepted = 0;
+    std::size_t rejected = 0;
+    std::vector<InputIssue> issues;
+
+    void clear();
+    void reject(std::size_t row, InputField field, InputError error);
+};
+
+/**
+ * @class SetpointImporter
+ * @brief Разбор таблиц уставок (CSV и двоичный формат HVST) с пакетной проверкой диапазонов.
+ *
+ * CSV: строки "зона,температура,влажность" (разделитель ',', ';' или табуляция),
+ * необязательная строка заголовка, комментарии с '#'. Сначала все строки
+ * разбираются в столбцы пакета, затем один проход по столбцам проверяет номера
+ * зон и диапазоны, и отклонённые строки удаляются из пакета. Буферы
+ * переиспользуются между вызовами. Ошибки строк попадают в отчёт, а не
+ * прерывают импорт; false означает, что файл не удалось прочитать целиком.
+ */
+class SetpointImporter {
+public:
+    explicit SetpointImporter(std::size_t zoneCount);
+
+    bool parseCsv(const char *data, std::size_t size, SetpointBatch &batch, ImportReport &report);
+    bool parseBinary(const void *data, std::size_t size, SetpointBatch &batch, ImportReport &report);
+    bool importFile(const std::string &path, SetpointBatch &batch, ImportReport &report); // Формат по сигнатуре
+
+private:
+    void rejectParsed(std::size_t row, InputField field, InputError error);
+    void validate(SetpointBatch &batch, ImportReport &report);
+
+    std::size_t zoneCount;
+    std::vector<std::uint32_t> rowOf;     // Номер строки файла для каждой записи пакета
+    std::vector<std::uint8_t> failedMask; // Биты отказавших полей записи
+    std::vector<InputIssue> parseIssues;  // Ошибки разбора по порядку строк, до слияния с ошибками диапазонов
+    std::size_t parseRejected = 0;        // Все ошибки разбора, включая не вошедшие в parseIssues
+    std::vector<char> fileBuffer;
+};
+
+bool saveSetpointBinary(const std::string &path, const SetpointBatch &batch); // Формат HVST
+
+} // namespace hvac
+
+#endif // INPUTVALIDATION_H
@@ -0,0 +1,351 @@
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+
+namespace hvac {
+
+namespace {
+
+/**
+ * @brief Гистограмма одного потока: пишет только владелец, снимок читает любой поток.
+ */
+struct ThreadHistogram {
+    std::atomic<std::uint64_t> counts[LatencyHistogram::kBucketCount];
+    std::atomic<std::uint64_t> sum;
+};
+
+/**
+ * @brief Метрики одного потока. Гистограммы выделяются при первом замере метрики.
+ */
+struct ThreadMetrics {
+    std::atomic<ThreadHistogram *> histograms[kMaxMetrics];
+    std::atomic<std::uint64_t> counters[kMaxMetrics];
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<MetricKind> kinds;
+    std::vector<ThreadMetrics *> threads; // Данные завершившихся потоков остаются, чтобы замеры не терялись
+};
+
+Registry &registry() {
+    // Не разрушается: потоки могут писать замеры и во время статической деинициализации
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+ThreadMetrics &threadMetrics() {
+    thread_local ThreadMetrics *local = nullptr;
+    if (local == nullptr) {
+        local = new ThreadMetrics(); // Значения обнуляются value-инициализацией
+        Registry &metrics = registry();
+        std::lock_guard<std::mutex> lock(metrics.mutex);
+        metrics.threads.push_back(local);
+    }
+    return *local;
+}
+
+// Единственный писатель: инкремент без атомарного RMW
+inline void bump(std::atomic<std::uint64_t> &value, std::uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+std::int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string jsonEscaped(const std::string &text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
+
+void appendFormat(std::string &out, const char *format, ...) {
+    char line[512];
+    va_list arguments;
+    va_start(arguments, format);
+    const int length = std::vsnprintf(line, sizeof(line), format, arguments);
+    va_end(arguments);
+    if (length > 0) {
+        out.append(line, std::min<std::size_t>(static_cast<std::size_t>(length), sizeof(line) - 1));
+    }
+}
+
+unsigned floorLog2(std::uint64_t value) {
+#if defined(__GNUC__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned result = 0;
+    while (value >>= 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+} // namespace
+
+std::size_t LatencyHistogram::bucketOf(std::uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<std::size_t>(value); // Малые значения — точно
+    }
+    const unsigned exponent = floorLog2(value);
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    const unsigned sub = static_cast<unsigned>(value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const unsigned exponent = static_cast<unsigned>(bucket / kSubBuckets) + kSubBucketBits - 1;
+    const std::uint64_t sub = bucket % kSubBuckets;
+    const std::uint64_t width = std::uint64_t(1) << (exponent - kSubBucketBits);
+    return ((kSubBuckets + sub) << (exponent - kSubBucketBits)) + width - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t value) {
+    ++counts[bucketOf(value)];
+    ++total;
+    sum += value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+}
+
+void LatencyHistogram::subtract(const LatencyHistogram &earlier) {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] -= std::min(counts[i], earlier.counts[i]);
+    }
+    total -= std::min(total, earlier.total);
+    sum -= std::min(sum, earlier.sum);
+}
+
+void LatencyHistogram::clear() {
+    counts.fill(0);
+    total = 0;
+    sum = 0;
+}
+
+std::uint64_t LatencyHistogram::percentile(double fraction) const {
+    if (total == 0) {
+        return 0;
+    }
+    const double clamped = std::min(std::max(fraction, 0.0), 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * total)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(kBucketCount - 1);
+}
+
+MetricsSnapshot MetricsSnapshot::since(const MetricsSnapshot &earlier) const {
+    // id метрик не меняются, новые добавляются в конец
+    MetricsSnapshot delta = *this;
+    const std::size_t common = std::min(metrics.size(), earlier.metrics.size());
+    for (std::size_t i = 0; i < common; ++i) {
+        MetricSummary &summary = delta.metrics[i];
+        summary.count -= std::min(summary.count, earlier.metrics[i].count);
+        summary.histogram.subtract(earlier.metrics[i].histogram);
+    }
+    return delta;
+}
+
+MetricId registerMetric(const char *name, MetricKind kind) {
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    for (std::size_t i = 0; i < metrics.names.size(); ++i) {
+        if (metrics.names[i] == name) {
+            return static_cast<MetricId>(i);
+        }
+    }
+    if (metrics.names.size() >= kMaxMetrics) {
+        return kInvalidMetric;
+    }
+    metrics.names.emplace_back(name);
+    metrics.kinds.push_back(kind);
+    return static_cast<MetricId>(metrics.names.size() - 1);
+}
+
+void recordLatency(MetricId id, std::uint64_t nanoseconds) {
+    if (id >= kMaxMetrics) {
+        return;
+    }
+    ThreadMetrics &local = threadMetrics();
+    ThreadHistogram *histogram = local.histograms[id].load(std::memory_order_relaxed);
+    if (histogram == nullptr) {
+        histogram = new ThreadHistogram();
+        local.histograms[id].store(histogram, std::memory_order_release);
+    }
+    bump(histogram->counts[LatencyHistogram::bucketOf(nanoseconds)], 1);
+    bump(histogram->sum, nanoseconds);
+}
+
+void addToCounter(MetricId id, std::uint64_t value) {
+    if (id >= kMaxMetrics) {
+        return;
+    }
+    bump(threadMetrics().counters[id], value);
+}
+
+MetricsSnapshot captureMetrics() {
+    MetricsSnapshot snapshot;
+    snapshot.timestampMs = nowMs();
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    snapshot.metrics.resize(metrics.names.size());
+    for (std::size_t id = 0; id < metrics.names.size(); ++id) {
+        MetricSummary &summary = snapshot.metrics[id];
+        summary.name = metrics.names[id];
+        summary.kind = metrics.kinds[id];
+        for (const ThreadMetrics *thread : metrics.threads) {
+            if (summary.kind == MetricKind::Counter) {
+                summary.count += thread->counters[id].load(std::memory_order_relaxed);
+                continue;
+            }
+            const ThreadHistogram *histogram = thread->histograms[id].load(std::memory_order_acquire);
+            if (histogram == nullptr) {
+                continue;
+            }
+            for (std::size_t bucket = 0; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+                const std::uint64_t count = histogram->counts[bucket].load(std::memory_order_relaxed);
+                if (count != 0) {
+                    summary.histogram.addBucket(bucket, count);
+                }
+            }
+            summary.histogram.addSum(histogram->sum.load(std::memory_order_relaxed));
+        }
+        if (summary.kind == MetricKind::Latency) {
+            summary.count = summary.histogram.count();
+        }
+    }
+    return snapshot;
+}
+
+std::string formatMetricsText(const MetricsSnapshot &snapshot) {
+    std::string out;
+    appendFormat(out, "metrics @ %lld ms\n", static_cast<long long>(snapshot.timestampMs));
+    for (const MetricSummary &metric : snapshot.metrics) {
+        if (metric.kind == MetricKind::Counter) {
+            appendFormat(out, "  %-24s %12llu\n", metric.name.c_str(), static_cast<unsigned long long>(metric.count));
+            continue;
+        }
+        const LatencyHistogram &h = metric.histogram;
+        appendFormat(out, "  %-24s n=%-10llu mean=%.1fus p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus\n",
+                     metric.name.c_str(), static_cast<unsigned long long>(metric.count), h.mean() / 1000.0,
+                     h.percentile(0.5) / 1000.0, h.percentile(0.9) / 1000.0, h.percentile(0.99) / 1000.0,
+                     h.percentile(0.999) / 1000.0, h.maximum() / 1000.0);
+    }
+    return out;
+}
+
+std::string formatMetricsJson(const MetricsSnapshot &snapshot) {
+    std::string out;
+    appendFormat(out, "{\"timestampMs\":%lld,\"metrics\":[", static_cast<long long>(snapshot.timestampMs));
+    for (std::size_t i = 0; i < snapshot.metrics.size(); ++i) {
+        const MetricSummary &metric = snapshot.metrics[i];
+        if (i > 0) {
+            out += ',';
+        }
+        const std::string name = jsonEscaped(metric.name);
+        if (metric.kind == MetricKind::Counter) {
+            appendFormat(out, "{\"name\":\"%s\",\"kind\":\"counter\",\"value\":%llu}", name.c_str(),
+                         static_cast<unsigned long long>(metric.count));
+            continue;
+        }
+        const LatencyHistogram &h = metric.histogram;
+        appendFormat(out,
+                     "{\"name\":\"%s\",\"kind\":\"latency\",\"count\":%llu,\"meanNs\":%.0f,\"p50Ns\":%llu,"
+                     "\"p90Ns\":%llu,\"p99Ns\":%llu,\"p999Ns\":%llu,\"maxNs\":%llu}",
+                     name.c_str(), static_cast<unsigned long long>(metric.count), h.mean(),
+                     static_cast<unsigned long long>(h.percentile(0.5)), static_cast<unsigned long long>(h.percentile(0.9)),
+                     static_cast<unsigned long long>(h.percentile(0.99)),
+                     static_cast<unsigned long long>(h.percentile(0.999)), static_cast<unsigned long long>(h.maximum()));
+    }
+    out += "]}\n";
+    return out;
+}
+
+MetricsDumper::MetricsDumper(const std::string &path, MetricsFormat format, std::chrono::milliseconds interval)
+    : path(path), format(format), interval(interval) {
+    previous = captureMetrics();
+    worker = std::thread(&MetricsDumper::run, this);
+}
+
+MetricsDumper::~MetricsDumper() {
+    stop();
+}
+
+void MetricsDumper::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+        dumpNow(); // Последний неполный период, иначе замеры перед выходом теряются
+    }
+}
+
+void MetricsDumper::dumpNow() {
+    std::lock_guard<std::mutex> lock(dumpMutex);
+    const MetricsSnapshot current = captureMetrics();
+    const MetricsSnapshot period = current.since(previous);
+    previous = current;
+    const std::string text = format == MetricsFormat::Json ? formatMetricsJson(period) : formatMetricsText(period);
+
+    if (path == "-") {
+        std::fputs(text.c_str(), stderr);
+        return;
+    }
+    // Целиком через временный файл, чтобы сборщик не прочитал половину снимка
+    const std::string temporaryPath = path + ".tmp";
+    std::FILE *file = std::fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        return;
+    }
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (std::fclose(file) != 0 || !written) {
+        std::remove(temporaryPath.c_str());
+        return;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    std::rename(temporaryPath.c_str(), path.c_str());
+}
+
+void MetricsDumper::run() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!wake.wait_for(lock, interval, [this]() { return stopping; })) {
+        lock.unlock();
+        dumpNow();
+        lock.lock();
+    }
+}
+
+} // namespace hvac
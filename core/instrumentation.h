@@ -0,0 +1,183 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Сборка с -DHVAC_INSTRUMENTATION=0 убирает макросы замеров из кода целиком
+#ifndef HVAC_INSTRUMENTATION
+#define HVAC_INSTRUMENTATION 1
+#endif
+
+namespace hvac {
+
+/**
+ * @brief Вид метрики.
+ */
+enum class MetricKind : std::uint8_t {
+    Latency, // Гистограмма длительностей, нс
+    Counter  // Счётчик событий
+};
+
+using MetricId = std::uint16_t;
+constexpr std::size_t kMaxMetrics = 64;
+constexpr MetricId kInvalidMetric = 0xFFFF; // Метрик больше kMaxMetrics: замеры отбрасываются
+
+/**
+ * @class LatencyHistogram
+ * @brief Гистограмма длительностей в духе HDR: логарифмические диапазоны по 16 линейных корзин.
+ *
+ * Относительная погрешность квантилей не больше 1/16; диапазон — до 2^36 нс
+ * (около 68 с), более длинные значения попадают в последнюю корзину.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 4;
+    static constexpr unsigned kSubBuckets = 1u << kSubBucketBits;
+    static constexpr unsigned kMaxExponent = 36;
+    static constexpr std::size_t kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets + kSubBuckets;
+
+    static std::size_t bucketOf(std::uint64_t value);
+    static std::uint64_t bucketUpperBound(std::size_t bucket); // Наибольшее значение, попадающее в корзину
+
+    void record(std::uint64_t value);
+    void addBucket(std::size_t bucket, std::uint64_t count) { counts[bucket] += count; total += count; }
+    void addSum(std::uint64_t value) { sum += value; }
+    void merge(const LatencyHistogram &other);
+    void subtract(const LatencyHistogram &earlier); // Разность двух снимков одной гистограммы
+    void clear();
+
+    std::uint64_t count() const { return total; }
+    std::uint64_t totalValue() const { return sum; }
+    double mean() const { return total == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(total); }
+    std::uint64_t percentile(double fraction) const; // fraction в [0, 1]; верхняя граница корзины
+    std::uint64_t maximum() const { return percentile(1.0); }
+
+private:
+    std::array<std::uint64_t, kBucketCount> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t sum = 0;
+};
+
+/**
+ * @brief Сводка одной метрики, собранная со всех потоков.
+ */
+struct MetricSummary {
+    std::string name;
+    MetricKind kind = MetricKind::Counter;
+    std::uint64_t count = 0;     // Замеров или значение счётчика
+    LatencyHistogram histogram;  // Только для Latency
+};
+
+/**
+ * @brief Снимок всех метрик процесса.
+ */
+struct MetricsSnapshot {
+    std::int64_t timestampMs = 0; // Время снимка, мс от эпохи Unix
+    std::vector<MetricSummary> metrics;
+
+    // Разность с более ранним снимком: замеры за прошедший период
+    MetricsSnapshot since(const MetricsSnapshot &earlier) const;
+};
+
+// Регистрация метрики по имени; повторная регистрация возвращает тот же id
+MetricId registerMetric(const char *name, MetricKind kind);
+
+void recordLatency(MetricId id, std::uint64_t nanoseconds); // Только в свои данные потока, без блокировок
+void addToCounter(MetricId id, std::uint64_t value);
+
+MetricsSnapshot captureMetrics(); // Сумма по всем потокам, включая завершившиеся
+
+std::string formatMetricsText(const MetricsSnapshot &snapshot);
+std::string formatMetricsJson(const MetricsSnapshot &snapshot);
+
+/**
+ * @class ScopedTimer
+ * @brief Замер длительности области видимости в гистограмму метрики.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(MetricId metric) : id(metric), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        recordLatency(id, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    MetricId id;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Формат периодической выгрузки метрик.
+ */
+enum class MetricsFormat {
+    Text,
+    Json
+};
+
+/**
+ * @class MetricsDumper
+ * @brief Периодически выгружает метрики за прошедший период из фонового потока.
+ *
+ * Путь "-" означает stderr (текст дописывается). Файл перезаписывается целиком
+ * через временный файл, поэтому читатель всегда видит законченный снимок.
+ */
+class MetricsDumper {
+public:
+    MetricsDumper(const std::string &path, MetricsFormat format,
+                  std::chrono::milliseconds interval = std::chrono::seconds(10));
+    ~MetricsDumper();
+
+    MetricsDumper(const MetricsDumper &) = delete;
+    MetricsDumper &operator=(const MetricsDumper &) = delete;
+
+    void dumpNow(); // Выгрузка вне расписания (например, при выходе)
+    void stop(); // Останавливает поток и выгружает замеры за последний неполный период
+
+private:
+    void run();
+
+    std::string path;
+    MetricsFormat format;
+    std::chrono::milliseconds interval;
+    MetricsSnapshot previous; // Только поток выгрузки и dumpNow() под dumpMutex
+    std::mutex dumpMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread worker;
+};
+
+} // namespace hvac
+
+#if HVAC_INSTRUMENTATION
+#define HVAC_METRIC_CONCAT_(a, b) a##b
+#define HVAC_METRIC_CONCAT(a, b) HVAC_METRIC_CONCAT_(a, b)
+// Замер длительности до конца области видимости; метрика регистрируется один раз на место вызова
+#define HVAC_SCOPED_TIMER(name)                                                                              \
+    static const ::hvac::MetricId HVAC_METRIC_CONCAT(hvacMetric_, __LINE__) =                                \
+        ::hvac::registerMetric(name, ::hvac::MetricKind::Latency);                                           \
+    const ::hvac::ScopedTimer HVAC_METRIC_CONCAT(hvacTimer_, __LINE__)(HVAC_METRIC_CONCAT(hvacMetric_, __LINE__))
+#define HVAC_COUNT(name, value)                                                                              \
+    do {                                                                                                     \
+        static const ::hvac::MetricId hvacCounterId = ::hvac::registerMetric(name, ::hvac::MetricKind::Counter); \
+        ::hvac::addToCounter(hvacCounterId, static_cast<std::uint64_t>(value));                              \
+    } while (0)
+#else
+#define HVAC_SCOPED_TIMER(name) ((void)0)
+#define HVAC_COUNT(name, value) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,90 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace hvac {
+
+/**
+ * @class MpscRing
+ * @brief Ограниченная lock-free очередь: много производителей, один потребитель.
+ *
+ * Кольцо ячеек с порядковыми номерами (схема Вьюкова). Производители
+ * резервируют позицию через CAS на хвосте, потребитель читает без атомарных
+ * RMW-операций. При заполнении tryPush возвращает false, ничего не блокируя.
+ */
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(std::size_t minCapacity) {
+        std::size_t capacity = 2;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        cells.reset(new Cell[capacity]);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // Можно вызывать из любого числа потоков
+    bool tryPush(const T &value) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::intptr_t difference =
+                static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // Очередь заполнена
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только из потока-потребителя
+    bool tryPop(T &value) {
+        Cell &cell = cells[head & mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(head + 1) < 0) {
+            return false; // Очередь пуста
+        }
+        value = cell.value;
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::size_t> tail{0}; // Позиция записи (производители)
+    alignas(64) std::size_t head = 0;             // Позиция чтения (потребитель)
+};
+
+} // namespace hvac
+
+#endif // MPSCRING_H
@@ -0,0 +1,271 @@
+#include "parametersweep.h"
+#include "inputvalidation.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+namespace hvac {
+
+namespace {
+constexpr double kSecondsPerHour = 3600.0;
+constexpr double kSecondsPerDay = 86400.0;
+constexpr double kJoulesPerKWh = 3.6e6;
+} // namespace
+
+std::size_t SweepGrid::size() const {
+    return temperatureSetpoints.size() * humiditySetpoints.size() * acPolicies.size() * louverPans.size() *
+           louverTilts.size();
+}
+
+SweepConfiguration SweepGrid::configuration(std::size_t index) const {
+    SweepConfiguration configuration;
+    configuration.louverTilt = louverTilts[index % louverTilts.size()];
+    index /= louverTilts.size();
+    configuration.louverPan = louverPans[index % louverPans.size()];
+    index /= louverPans.size();
+    configuration.policy = acPolicies[index % acPolicies.size()];
+    index /= acPolicies.size();
+    configuration.humiditySetpoint = humiditySetpoints[index % humiditySetpoints.size()];
+    index /= humiditySetpoints.size();
+    configuration.temperatureSetpoint = temperatureSetpoints[index % temperatureSetpoints.size()];
+    return configuration;
+}
+
+LoadProfile syntheticLoadProfile(const ClimateProfile &climate, double startTime, double duration, double timeStep) {
+    LoadProfile profile;
+    profile.name = "synthetic";
+    profile.timeStep = timeStep;
+    profile.startTime = startTime;
+    profile.outdoorHumidity = climate.humidity;
+    const std::size_t steps = timeStep > 0 ? static_cast<std::size_t>(duration / timeStep) : 0;
+    profile.outdoorTemperature.reserve(steps);
+    profile.occupancy.reserve(steps);
+    for (std::size_t i = 0; i < steps; ++i) {
+        const double time = startTime + static_cast<double>(i) * timeStep;
+        const auto day = static_cast<long long>(time / kSecondsPerDay) % 7;
+        const double hour = std::fmod(time, kSecondsPerDay) / kSecondsPerHour;
+        profile.outdoorTemperature.push_back(climate.outdoorTemperature(time));
+        profile.occupancy.push_back(day < 5 && hour >= 8.0 && hour < 18.0 ? 1.0 : 0.0);
+    }
+    return profile;
+}
+
+bool loadLoadProfileCsv(const std::string &path, double timeStep, LoadProfile &profile) {
+    std::FILE *file = std::fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    LoadProfile loaded;
+    loaded.name = path;
+    loaded.timeStep = timeStep;
+    char line[256];
+    bool ok = timeStep > 0;
+    while (ok && std::fgets(line, sizeof(line), file) != nullptr) {
+        const char *start = line;
+        const char *end = line + std::strlen(line);
+        // Строка длиннее буфера: fgets разрезал бы её на две, и хвост прочитался бы как отдельная строка
+        if ((end == start || end[-1] != '\n') && !std::feof(file)) {
+            ok = false;
+            break;
+        }
+        while (end > start && (end[-1] == '\n' || end[-1] == '\r')) {
+            --end;
+        }
+        while (start < end && (*start == ' ' || *start == '\t')) {
+            ++start;
+        }
+        if (start == end || *start == '#') {
+            continue;
+        }
+        const char *separator = start;
+        while (separator < end && *separator != ',' && *separator != ';') {
+            ++separator;
+        }
+        double outdoor = 0;
+        double occupancy = 0;
+        ok = separator < end && parseNumber(start, separator, outdoor) == InputError::None &&
+             parseNumber(separator + 1, end, occupancy) == InputError::None && occupancy >= 0;
+        loaded.outdoorTemperature.push_back(outdoor);
+        loaded.occupancy.push_back(occupancy);
+    }
+    std::fclose(file);
+    if (!ok || loaded.steps() == 0) {
+        return false;
+    }
+    profile = std::move(loaded);
+    return true;
+}
+
+void SweepMetrics::add(const SweepMetrics &other) {
+    energyKWh += other.energyKWh;
+    discomfortDegreeHours += other.discomfortDegreeHours;
+    hoursOutsideBand += other.hoursOutsideBand;
+    humidityHoursOutsideBand += other.humidityHoursOutsideBand;
+    occupiedHours += other.occupiedHours;
+}
+
+double louverDeliveryFactor(std::int16_t pan, std::int16_t tilt) {
+    // Струя в сторону от занятой зоны теряет до трети мощности; лучшее перемешивание при наклоне около 30°
+    const double panOffset = std::abs(pan - 90) / 90.0;
+    const double tiltOffset = (tilt - 30) / 60.0;
+    const double factor = 1.0 - 0.3 * panOffset * panOffset - 0.2 * tiltOffset * tiltOffset;
+    return std::min(1.0, std::max(0.5, factor));
+}
+
+/**
+ * @brief Рабочая память одного потока пула: переиспользуется всеми его задачами.
+ */
+struct SweepEvaluator::Workspace {
+    ZoneStore store;
+    SimulationEngine engine{store};
+    std::vector<ZoneStore::ZoneId> ids;
+    std::vector<ZoneStore::ZoneId> occupancyControlled; // Зоны с политикой Occupied
+    std::vector<double> setpointTemperature;
+    std::vector<double> setpointHumidity;
+    std::vector<double> discomfort;
+    std::vector<double> hoursOutside;
+    std::vector<double> humidityHoursOutside;
+};
+
+SweepEvaluator::SweepEvaluator(WorkStealingPool &pool, const SweepOptions &options)
+    : pool(pool), options(options) {
+}
+
+SweepEvaluator::~SweepEvaluator() = default;
+
+bool SweepEvaluator::evaluate(const SweepGrid &grid, const std::vector<LoadProfile> &profiles, SweepReport &report) {
+    const std::size_t configurationCount = grid.size();
+    if (configurationCount == 0 || profiles.empty()) {
+        return false;
+    }
+    for (const LoadProfile &profile : profiles) {
+        if (profile.steps() == 0 || !(profile.timeStep > 0)) {
+            return false;
+        }
+    }
+
+    report.configurationCount = configurationCount;
+    report.profileCount = profiles.size();
+    report.perProfile.assign(configurationCount * profiles.size(), SweepMetrics());
+    report.total.assign(configurationCount, SweepMetrics());
+    while (workspaces.size() < pool.workerCount()) {
+        workspaces.push_back(std::make_unique<Workspace>());
+    }
+
+    // Задача — кусок вариантов на одном профиле; потоки пишут в разные части perProfile
+    const std::size_t chunkSize = std::max<std::size_t>(1, options.configurationsPerTask);
+    const std::size_t chunksPerProfile = (configurationCount + chunkSize - 1) / chunkSize;
+    pool.parallelFor(chunksPerProfile * profiles.size(), 1,
+                     [&](std::size_t begin, std::size_t end, unsigned worker) {
+                         for (std::size_t task = begin; task < end; ++task) {
+                             const std::size_t profile = task / chunksPerProfile;
+                             const std::size_t first = (task % chunksPerProfile) * chunkSize;
+                             const std::size_t count = std::min(chunkSize, configurationCount - first);
+                             evaluateChunk(*workspaces[worker], grid, profiles[profile], first, count,
+                                           &report.perProfile[profile * configurationCount + first]);
+                         }
+                     });
+
+    for (std::size_t profile = 0; profile < profiles.size(); ++profile) {
+        for (std::size_t configuration = 0; configuration < configurationCount; ++configuration) {
+            report.total[configuration].add(report.metrics(configuration, profile));
+        }
+    }
+    return true;
+}
+
+void SweepEvaluator::evaluateChunk(Workspace &workspace, const SweepGrid &grid, const LoadProfile &profile,
+                                   std::size_t first, std::size_t count, SweepMetrics *out) const {
+    ZoneStore &store = workspace.store;
+    SimulationEngine &engine = workspace.engine;
+    // Отсчёт профиля держится постоянным на substeps шагах модели
+    const std::size_t substeps =
+        options.maxTimeStep > 0
+            ? std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(profile.timeStep / options.maxTimeStep)))
+            : 1;
+    const double modelStep = profile.timeStep / static_cast<double>(substeps);
+
+    store.resize(count);
+    engine.syncZoneCount();
+    engine.setTimeStep(modelStep);
+    engine.setTemperatureGains(options.temperatureGains);
+    engine.setHumidityGains(options.humidityGains);
+    ClimateProfile climate;
+    climate.humidity = profile.outdoorHumidity;
+    engine.setClimate(climate);
+    engine.reset(profile.startTime);
+
+    const bool occupiedAtStart = profile.occupancy[0] > 0;
+    workspace.ids.resize(count);
+    std::iota(workspace.ids.begin(), workspace.ids.end(), ZoneStore::ZoneId(0));
+    workspace.occupancyControlled.clear();
+    workspace.setpointTemperature.resize(count);
+    workspace.setpointHumidity.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const SweepConfiguration configuration = grid.configuration(first + i);
+        const auto zone = static_cast<ZoneStore::ZoneId>(i);
+        workspace.setpointTemperature[i] = configuration.temperatureSetpoint;
+        workspace.setpointHumidity[i] = configuration.humiditySetpoint;
+        ZoneThermalParameters parameters = options.zone;
+        parameters.hvacPower *= louverDeliveryFactor(configuration.louverPan, configuration.louverTilt);
+        engine.setZoneParameters(zone, parameters);
+        store.setReading(zone, options.initialTemperature, options.initialHumidity, store.pressure(zone));
+        store.setLouver(zone, configuration.louverPan, configuration.louverTilt);
+        if (configuration.policy == ACPolicy::Occupied) {
+            workspace.occupancyControlled.push_back(zone);
+        }
+        store.setACStatus(zone, configuration.policy == ACPolicy::AlwaysOn ||
+                                    (configuration.policy == ACPolicy::Occupied && occupiedAtStart));
+    }
+    store.setSetpoints(workspace.ids.data(), count, workspace.setpointTemperature.data(),
+                       workspace.setpointHumidity.data());
+    workspace.discomfort.assign(count, 0.0);
+    workspace.hoursOutside.assign(count, 0.0);
+    workspace.humidityHoursOutside.assign(count, 0.0);
+
+    const ComfortBand &band = options.comfort;
+    const double stepHours = modelStep / kSecondsPerHour;
+    const std::size_t steps = profile.steps();
+    double occupiedHours = 0;
+    bool wasOccupied = occupiedAtStart;
+    for (std::size_t s = 0; s < steps; ++s) {
+        const bool occupied = profile.occupancy[s] > 0;
+        if (occupied != wasOccupied && !workspace.occupancyControlled.empty()) {
+            store.setACStatus(workspace.occupancyControlled.data(), workspace.occupancyControlled.size(), occupied);
+        }
+        wasOccupied = occupied;
+        for (std::size_t substep = 0; substep < substeps; ++substep) {
+            engine.step(profile.outdoorTemperature[s], profile.occupancy[s]);
+            if (!occupied) {
+                continue;
+            }
+
+            // Комфорт считается только в занятые часы
+            occupiedHours += stepHours;
+            const double *temperature = store.temperatures();
+            const double *humidity = store.humidities();
+            for (std::size_t i = 0; i < count; ++i) {
+                const double deviation = std::max(0.0, temperature[i] - band.maxTemperature) +
+                                         std::max(0.0, band.minTemperature - temperature[i]);
+                workspace.discomfort[i] += deviation * stepHours;
+                workspace.hoursOutside[i] += deviation > 0 ? stepHours : 0.0;
+                const bool humidityOutside = humidity[i] < band.minHumidity || humidity[i] > band.maxHumidity;
+                workspace.humidityHoursOutside[i] += humidityOutside ? stepHours : 0.0;
+            }
+        }
+    }
+
+    const double *energy = engine.energy();
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i].energyKWh = energy[i] / kJoulesPerKWh;
+        out[i].discomfortDegreeHours = workspace.discomfort[i];
+        out[i].hoursOutsideBand = workspace.hoursOutside[i];
+        out[i].humidityHoursOutsideBand = workspace.humidityHoursOutside[i];
+        out[i].occupiedHours = occupiedHours;
+    }
+}
+
+} // namespace hvac
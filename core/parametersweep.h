@@ -0,0 +1,163 @@
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include "thermalsim.h"
+#include "workpool.h"
+#include "zonestore.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Политика работы кондиционера в варианте расчёта.
+ */
+enum class ACPolicy : std::uint8_t {
+    AlwaysOn, // Включён всё время
+    Occupied, // Включён, только когда помещение занято
+    Off       // Выключен
+};
+
+/**
+ * @brief Один вариант настроек: то, что задают диалог настроек, кнопка кондиционера и слайдеры жалюзи.
+ */
+struct SweepConfiguration {
+    double temperatureSetpoint = 22.0; // °C
+    double humiditySetpoint = 45.0;    // %
+    ACPolicy policy = ACPolicy::AlwaysOn;
+    std::int16_t louverPan = 90;       // 0..180°, 90 — прямо
+    std::int16_t louverTilt = 30;      // 0..90°
+};
+
+/**
+ * @brief Сетка вариантов: все сочетания значений по осям.
+ *
+ * Варианты не хранятся, а вычисляются по номеру; быстрее всего меняется наклон жалюзи.
+ */
+struct SweepGrid {
+    std::vector<double> temperatureSetpoints{22.0};
+    std::vector<double> humiditySetpoints{45.0};
+    std::vector<ACPolicy> acPolicies{ACPolicy::AlwaysOn};
+    std::vector<std::int16_t> louverPans{90};
+    std::vector<std::int16_t> louverTilts{30};
+
+    std::size_t size() const;
+    SweepConfiguration configuration(std::size_t index) const;
+};
+
+/**
+ * @brief Профиль нагрузки площадки: наружная температура и занятость на каждом шаге.
+ *
+ * Берётся из выгрузки системы здания или строится syntheticLoadProfile().
+ */
+struct LoadProfile {
+    std::string name;
+    double timeStep = 300.0;       // Шаг точек, с
+    double startTime = 0.0;        // Время первой точки от начала года, с
+    double outdoorHumidity = 60.0; // %
+    std::vector<double> outdoorTemperature; // °C
+    std::vector<double> occupancy;          // Множитель внутренних теплопритоков; > 0 — помещение занято
+
+    std::size_t steps() const { return std::min(outdoorTemperature.size(), occupancy.size()); }
+};
+
+// Наружная температура по климату; занятость 1 по будням с 8 до 18 (день 0 — понедельник), иначе 0
+LoadProfile syntheticLoadProfile(const ClimateProfile &climate, double startTime, double duration,
+                                 double timeStep = 300.0);
+// Строки "наружная температура,занятость"; строки с '#' в начале пропускаются.
+// Строка длиннее 254 символов считается ошибкой формата
+bool loadLoadProfileCsv(const std::string &path, double timeStep, LoadProfile &profile);
+
+/**
+ * @brief Полоса комфорта, по которой оцениваются варианты (не зависит от уставок варианта).
+ */
+struct ComfortBand {
+    double minTemperature = 20.0;
+    double maxTemperature = 24.0;
+    double minHumidity = 30.0;
+    double maxHumidity = 60.0;
+};
+
+/**
+ * @brief Итоги одного варианта: энергия и нарушения комфорта в занятые часы.
+ */
+struct SweepMetrics {
+    double energyKWh = 0;
+    double discomfortDegreeHours = 0;    // Сумма отклонений температуры от полосы, °C·ч
+    double hoursOutsideBand = 0;         // Занятые часы с температурой вне полосы
+    double humidityHoursOutsideBand = 0; // Занятые часы с влажностью вне полосы
+    double occupiedHours = 0;
+
+    void add(const SweepMetrics &other);
+};
+
+/**
+ * @brief Параметры расчёта, общие для всех вариантов.
+ */
+struct SweepOptions {
+    ComfortBand comfort;
+    ZoneThermalParameters zone;
+    PidGains temperatureGains{0.5, 0.0005, 0.0};
+    PidGains humidityGains{0.1, 0.0001, 0.0};
+    double initialTemperature = 22.0;
+    double initialHumidity = 45.0;
+    std::size_t configurationsPerTask = 256; // Вариантов в одном прогоне модели (зон в ZoneStore)
+    // Наибольший шаг модели, с: явный Эйлер с ПИД-регулятором при шаге профиля в час раскачивается,
+    // поэтому каждый отсчёт профиля считается несколькими равными шагами не длиннее этого
+    double maxTimeStep = 300.0;
+};
+
+/**
+ * @brief Результаты расчёта по всем вариантам и профилям.
+ */
+struct SweepReport {
+    std::size_t configurationCount = 0;
+    std::size_t profileCount = 0;
+    std::vector<SweepMetrics> perProfile; // [профиль * configurationCount + вариант]
+    std::vector<SweepMetrics> total;      // Сумма по профилям для каждого варианта
+
+    const SweepMetrics &metrics(std::size_t configuration, std::size_t profile) const {
+        return perProfile[profile * configurationCount + configuration];
+    }
+};
+
+// Доля мощности кондиционера, доходящая до занятой зоны при данном положении жалюзи (грубая оценка)
+double louverDeliveryFactor(std::int16_t pan, std::int16_t tilt);
+
+/**
+ * @class SweepEvaluator
+ * @brief Пакетный расчёт вариантов настроек на профилях нагрузки по всем ядрам.
+ *
+ * Варианты считаются как зоны одной модели SimulationEngine: кусок из
+ * configurationsPerTask вариантов прогоняется по одному профилю за задачу пула.
+ * У каждого потока своя рабочая память (ZoneStore, модель, накопители), которая
+ * переиспользуется между задачами; результаты пишутся в непересекающиеся части
+ * отчёта, поэтому общего изменяемого состояния у потоков нет.
+ */
+class SweepEvaluator {
+public:
+    explicit SweepEvaluator(WorkStealingPool &pool, const SweepOptions &options = SweepOptions());
+    ~SweepEvaluator();
+
+    // false, если сетка пуста или у профиля нет точек
+    bool evaluate(const SweepGrid &grid, const std::vector<LoadProfile> &profiles, SweepReport &report);
+
+private:
+    struct Workspace;
+
+    void evaluateChunk(Workspace &workspace, const SweepGrid &grid, const LoadProfile &profile, std::size_t first,
+                       std::size_t count, SweepMetrics *out) const;
+
+    WorkStealingPool &pool;
+    SweepOptions options;
+    std::vector<std::unique_ptr<Workspace>> workspaces; // По одной на поток пула
+};
+
+} // namespace hvac
+
+#endif // PARAMETERSWEEP_H
@@ -0,0 +1,100 @@
+#include "readoutformatter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace hvac {
+
+namespace {
+// Показания выводятся с двумя знаками после запятой
+std::int64_t hundredths(double value) {
+    return std::llround(value * 100.0);
+}
+
+char *appendText(char *out, const char *end, const char *text) {
+    const std::size_t length = std::min<std::size_t>(std::strlen(text), static_cast<std::size_t>(end - out));
+    std::memcpy(out, text, length);
+    return out + length;
+}
+
+// Целое значение в сотых долях как "123.45" без обращения к локали
+char *appendFixed2(char *out, const char *end, std::int64_t hundredthsValue) {
+    if (hundredthsValue < 0 && out < end) {
+        *out++ = '-';
+        hundredthsValue = -hundredthsValue;
+    }
+    out = std::to_chars(out, const_cast<char *>(end), hundredthsValue / 100).ptr;
+    if (end - out >= 3) {
+        const int fraction = static_cast<int>(hundredthsValue % 100);
+        *out++ = '.';
+        *out++ = static_cast<char>('0' + fraction / 10);
+        *out++ = static_cast<char>('0' + fraction % 10);
+    }
+    return out;
+}
+} // namespace
+
+void ReadoutFormatter::setPrefix(Field field, std::string_view utf8Prefix) {
+    Slot &slot = slots[field];
+    slot.prefixLength = std::min(utf8Prefix.size(), kMaxPrefix);
+    std::memcpy(slot.text, utf8Prefix.data(), slot.prefixLength);
+    if (slot.hasValue) {
+        dirtyMask |= 1u << field;
+    }
+}
+
+bool ReadoutFormatter::assign(Field field, std::int64_t key, int unit) {
+    Slot &slot = slots[field];
+    if (slot.hasValue && slot.key == key && slot.unit == unit) {
+        return false;
+    }
+    slot.key = key;
+    slot.unit = unit;
+    slot.hasValue = true;
+    dirtyMask |= 1u << field;
+    return true;
+}
+
+bool ReadoutFormatter::setTemperature(double value, TemperatureUnit unit) {
+    return assign(Temperature, hundredths(value), static_cast<int>(unit));
+}
+
+bool ReadoutFormatter::setHumidity(int value) {
+    return assign(Humidity, value, 0);
+}
+
+bool ReadoutFormatter::setPressure(double value, PressureUnit unit) {
+    return assign(Pressure, hundredths(value), static_cast<int>(unit));
+}
+
+std::string_view ReadoutFormatter::take(Field field) {
+    Slot &slot = slots[field];
+    char *out = slot.text + slot.prefixLength;
+    const char *end = slot.text + kBufferSize;
+
+    switch (field) {
+    case Temperature:
+        out = appendFixed2(out, end, slot.key);
+        out = appendText(out, end, " ");
+        out = appendText(out, end, unitSymbol(static_cast<TemperatureUnit>(slot.unit)));
+        break;
+    case Humidity:
+        out = std::to_chars(out, const_cast<char *>(end), slot.key).ptr;
+        out = appendText(out, end, " %");
+        break;
+    case Pressure:
+        out = appendFixed2(out, end, slot.key);
+        out = appendText(out, end, " ");
+        out = appendText(out, end, unitSymbol(static_cast<PressureUnit>(slot.unit)));
+        break;
+    case FieldCount:
+        break;
+    }
+
+    dirtyMask &= ~(1u << field);
+    return std::string_view(slot.text, static_cast<std::size_t>(out - slot.text));
+}
+
+} // namespace hvac
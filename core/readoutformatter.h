@@ -0,0 +1,63 @@
+#ifndef READOUTFORMATTER_H
+#define READOUTFORMATTER_H
+
+#include "units.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace hvac {
+
+/**
+ * @class ReadoutFormatter
+ * @brief Текст меток показаний с отслеживанием изменений и без выделений памяти.
+ *
+ * Для каждого поля хранится ключ последнего показанного значения (с точностью
+ * отображения) и собственный буфер с заранее записанным префиксом. Поле
+ * помечается изменённым, только если его текст действительно станет другим;
+ * форматируется только изменённое поле и только в свой буфер.
+ */
+class ReadoutFormatter {
+public:
+    enum Field {
+        Temperature,
+        Humidity,
+        Pressure,
+        FieldCount
+    };
+
+    void setPrefix(Field field, std::string_view utf8Prefix); // Например "Температура: "
+
+    // Возвращают true, если текст поля изменится
+    bool setTemperature(double value, TemperatureUnit unit);
+    bool setHumidity(int value);
+    bool setPressure(double value, PressureUnit unit);
+
+    bool isDirty(Field field) const { return (dirtyMask & (1u << field)) != 0; }
+    bool anyDirty() const { return dirtyMask != 0; }
+
+    // Форматирует поле в его буфер и снимает флаг; представление действительно до следующего вызова
+    std::string_view take(Field field);
+
+private:
+    static constexpr std::size_t kBufferSize = 96;
+    static constexpr std::size_t kMaxPrefix = 64;
+
+    struct Slot {
+        char text[kBufferSize] = {};
+        std::size_t prefixLength = 0;
+        std::int64_t key = 0;   // Значение в сотых долях (точность отображения)
+        int unit = -1;          // Единицы последнего значения
+        bool hasValue = false;  // Значение ещё ни разу не задавалось
+    };
+
+    bool assign(Field field, std::int64_t key, int unit);
+
+    Slot slots[FieldCount];
+    std::uint32_t dirtyMask = 0;
+};
+
+} // namespace hvac
+
+#endif // READOUTFORMATTER_H
@@ -0,0 +1,219 @@
+#include "scheduleengine.h"
+
+#include <algorithm>
+
+namespace hvac {
+
+namespace {
+constexpr std::uint32_t kNoSlot = 0xFFFFFFFFu;
+constexpr std::int64_t kEpochMondayOffset = 3 * static_cast<std::int64_t>(kSecondsPerDay); // 01.01.1970 — четверг
+} // namespace
+
+ScheduleTime scheduleTimeFromUnix(std::int64_t unixSeconds, std::int32_t utcOffsetSeconds) {
+    const std::int64_t local = unixSeconds + utcOffsetSeconds + kEpochMondayOffset;
+    return local > 0 ? static_cast<ScheduleTime>(local) : 0;
+}
+
+ScheduleEngine::ScheduleEngine(std::size_t zoneCount, ScheduleTime start)
+    : wheel(start) {
+    resize(zoneCount);
+}
+
+void ScheduleEngine::resize(std::size_t zoneCount) {
+    for (std::size_t zone = zoneCount; zone < zoneProgram.size(); ++zone) {
+        wheel.cancel(transitionHandle[zone]);
+        wheel.cancel(overrideHandle[zone]);
+    }
+    zoneProgram.resize(zoneCount, kNoProgram);
+    transitionHandle.resize(zoneCount);
+    nextTransitionTime.resize(zoneCount, 0);
+    overrideHandle.resize(zoneCount);
+    zoneOverridden.resize(zoneCount, 0);
+    overrideToTransition.resize(zoneCount, 0);
+    slotOfZone.assign(zoneCount, kNoSlot);
+    due.clear();
+}
+
+ScheduleEngine::ProgramId ScheduleEngine::addProgram(const SetpointProgram &program) {
+    CompiledProgram compiled;
+    compiled.levels = program;
+    for (const ProgramPoint &point : program.points) {
+        for (std::uint32_t day = 0; day < 7; ++day) {
+            if ((point.days & (1u << day)) != 0) {
+                compiled.transitions.push_back(
+                    Transition{day * kSecondsPerDay + std::min(point.secondOfDay, kSecondsPerDay - 1), point.mode});
+            }
+        }
+    }
+    if (compiled.transitions.empty()) {
+        return kNoProgram;
+    }
+    // При совпадении времени действует точка, указанная в программе позже
+    std::stable_sort(compiled.transitions.begin(), compiled.transitions.end(),
+                     [](const Transition &a, const Transition &b) { return a.weekSecond < b.weekSecond; });
+    std::vector<Transition> &transitions = compiled.transitions;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < transitions.size(); ++i) {
+        if (kept > 0 && transitions[kept - 1].weekSecond == transitions[i].weekSecond) {
+            transitions[kept - 1] = transitions[i];
+        } else {
+            transitions[kept++] = transitions[i];
+        }
+    }
+    transitions.resize(kept);
+
+    programs.push_back(std::move(compiled));
+    return static_cast<ProgramId>(programs.size() - 1);
+}
+
+std::uint32_t ScheduleEngine::transitionAt(const CompiledProgram &program, ScheduleTime time) const {
+    const std::uint32_t offset = static_cast<std::uint32_t>(time % kSecondsPerWeek);
+    const auto after = std::upper_bound(program.transitions.begin(), program.transitions.end(), offset,
+                                        [](std::uint32_t value, const Transition &t) { return value < t.weekSecond; });
+    // До первой точки недели действует последняя точка прошлой недели
+    const std::size_t index = after == program.transitions.begin() ? program.transitions.size() - 1
+                                                                     : static_cast<std::size_t>(after - program.transitions.begin()) - 1;
+    return static_cast<std::uint32_t>(index);
+}
+
+bool ScheduleEngine::assignProgram(ZoneStore::ZoneId zone, ProgramId program) {
+    if (zone >= zoneProgram.size() || (program != kNoProgram && program >= programs.size())) {
+        return false;
+    }
+    wheel.cancel(transitionHandle[zone]);
+    transitionHandle[zone] = Wheel::Handle();
+    nextTransitionTime[zone] = 0;
+    zoneProgram[zone] = program;
+
+    if (program != kNoProgram) {
+        const CompiledProgram &compiled = programs[program];
+        const ScheduleTime time = wheel.now();
+        const std::uint32_t current = transitionAt(compiled, time);
+        if (!zoneOverridden[zone]) {
+            emitProgramLevel(zone, compiled.transitions[current].mode);
+        }
+        const std::uint32_t next = static_cast<std::uint32_t>((current + 1) % compiled.transitions.size());
+        const ScheduleTime weekStart = time - time % kSecondsPerWeek;
+        ScheduleTime when = weekStart + compiled.transitions[next].weekSecond;
+        if (when <= time) {
+            when += kSecondsPerWeek;
+        }
+        scheduleTransition(zone, next, when);
+    }
+
+    // Срок переопределения "до переключения" относился к прежней программе
+    if (zoneOverridden[zone] && overrideToTransition[zone]) {
+        scheduleOverrideEnd(zone, nextTransitionTime[zone]);
+    }
+    return true;
+}
+
+void ScheduleEngine::scheduleTransition(ZoneStore::ZoneId zone, std::uint32_t transition, ScheduleTime when) {
+    Event event;
+    event.zone = zone;
+    event.transition = transition;
+    event.kind = EventKind::Transition;
+    transitionHandle[zone] = wheel.schedule(when, event);
+    nextTransitionTime[zone] = when;
+}
+
+bool ScheduleEngine::overrideZone(ZoneStore::ZoneId zone, double temperature, double humidity, ScheduleTime until) {
+    if (zone >= zoneProgram.size()) {
+        return false;
+    }
+    zoneOverridden[zone] = 1;
+    overrideToTransition[zone] = until == 0;
+    emit(zone, temperature, humidity);
+    scheduleOverrideEnd(zone, until == 0 ? nextTransitionTime[zone] : until);
+    return true;
+}
+
+void ScheduleEngine::scheduleOverrideEnd(ZoneStore::ZoneId zone, ScheduleTime until) {
+    wheel.cancel(overrideHandle[zone]);
+    overrideHandle[zone] = Wheel::Handle();
+    if (until != 0) {
+        // Без программы и без срока переопределение действует до clearOverride()
+        Event event;
+        event.zone = zone;
+        event.kind = EventKind::OverrideEnd;
+        overrideHandle[zone] = wheel.schedule(until, event);
+    }
+}
+
+void ScheduleEngine::clearOverride(ZoneStore::ZoneId zone) {
+    if (zone >= zoneProgram.size() || !zoneOverridden[zone]) {
+        return;
+    }
+    wheel.cancel(overrideHandle[zone]);
+    overrideHandle[zone] = Wheel::Handle();
+    zoneOverridden[zone] = 0;
+    if (zoneProgram[zone] != kNoProgram) {
+        const CompiledProgram &compiled = programs[zoneProgram[zone]];
+        emitProgramLevel(zone, compiled.transitions[transitionAt(compiled, wheel.now())].mode);
+    }
+}
+
+void ScheduleEngine::emitProgramLevel(ZoneStore::ZoneId zone, ScheduleMode mode) {
+    const SetpointProgram &levels = programs[zoneProgram[zone]].levels;
+    if (mode == ScheduleMode::Comfort) {
+        emit(zone, levels.comfortTemperature, levels.comfortHumidity);
+    } else {
+        emit(zone, levels.setbackTemperature, levels.setbackHumidity);
+    }
+}
+
+void ScheduleEngine::emit(ZoneStore::ZoneId zone, double temperature, double humidity) {
+    std::uint32_t &slot = slotOfZone[zone];
+    if (slot == kNoSlot) {
+        slot = static_cast<std::uint32_t>(due.zones.size());
+        due.zones.push_back(zone);
+        due.temperature.push_back(temperature);
+        due.humidity.push_back(humidity);
+    } else {
+        due.temperature[slot] = temperature;
+        due.humidity[slot] = humidity;
+    }
+}
+
+std::size_t ScheduleEngine::advance(ScheduleTime now, SetpointBatch &batch) {
+    fired.clear();
+    wheel.advance(now, fired);
+    for (const Wheel::Fired &entry : fired) {
+        const Event &event = entry.payload;
+        const ZoneStore::ZoneId zone = event.zone;
+        if (zoneProgram[zone] == kNoProgram && event.kind == EventKind::Transition) {
+            continue;
+        }
+        if (event.kind == EventKind::OverrideEnd) {
+            overrideHandle[zone] = Wheel::Handle();
+            zoneOverridden[zone] = 0;
+            if (zoneProgram[zone] != kNoProgram) {
+                const CompiledProgram &compiled = programs[zoneProgram[zone]];
+                emitProgramLevel(zone, compiled.transitions[transitionAt(compiled, entry.tick)].mode);
+            }
+            continue;
+        }
+
+        // Переключение программы: следующая точка известна без поиска
+        const CompiledProgram &compiled = programs[zoneProgram[zone]];
+        if (!zoneOverridden[zone]) {
+            emitProgramLevel(zone, compiled.transitions[event.transition].mode);
+        }
+        const std::uint32_t next = static_cast<std::uint32_t>((event.transition + 1) % compiled.transitions.size());
+        ScheduleTime when = entry.tick - compiled.transitions[event.transition].weekSecond +
+                            compiled.transitions[next].weekSecond;
+        if (next <= event.transition) {
+            when += kSecondsPerWeek;
+        }
+        scheduleTransition(zone, next, when);
+    }
+
+    batch.clear();
+    std::swap(batch, due);
+    for (ZoneStore::ZoneId zone : batch.zones) {
+        slotOfZone[zone] = kNoSlot;
+    }
+    return batch.size();
+}
+
+} // namespace hvac
@@ -0,0 +1,147 @@
+#ifndef SCHEDULEENGINE_H
+#define SCHEDULEENGINE_H
+
+#include "timerwheel.h"
+#include "zonestore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hvac {
+
+// Время расписания: секунды местного времени от понедельника 29.12.1969, 00:00
+using ScheduleTime = std::uint64_t;
+
+constexpr std::uint32_t kSecondsPerDay = 24 * 3600;
+constexpr std::uint32_t kSecondsPerWeek = 7 * kSecondsPerDay;
+
+ScheduleTime scheduleTimeFromUnix(std::int64_t unixSeconds, std::int32_t utcOffsetSeconds);
+
+/**
+ * @brief Дни недели для точек программы (битовая маска).
+ */
+enum ScheduleDays : std::uint8_t {
+    kMonday = 1 << 0,
+    kTuesday = 1 << 1,
+    kWednesday = 1 << 2,
+    kThursday = 1 << 3,
+    kFriday = 1 << 4,
+    kSaturday = 1 << 5,
+    kSunday = 1 << 6,
+    kWeekdays = kMonday | kTuesday | kWednesday | kThursday | kFriday,
+    kWeekend = kSaturday | kSunday,
+    kEveryDay = kWeekdays | kWeekend
+};
+
+/**
+ * @brief Режим зоны по программе: комфорт или экономичное снижение (setback).
+ */
+enum class ScheduleMode : std::uint8_t {
+    Comfort,
+    Setback
+};
+
+/**
+ * @brief Точка переключения режима: в указанные дни в secondOfDay.
+ */
+struct ProgramPoint {
+    std::uint8_t days = kEveryDay;
+    std::uint32_t secondOfDay = 0;
+    ScheduleMode mode = ScheduleMode::Comfort;
+};
+
+/**
+ * @brief Недельная программа: уставки двух режимов и моменты переключения.
+ */
+struct SetpointProgram {
+    double comfortTemperature = 22.0; // °C
+    double comfortHumidity = 45.0;    // %
+    double setbackTemperature = 17.0;
+    double setbackHumidity = 50.0;
+    std::vector<ProgramPoint> points;
+};
+
+/**
+ * @class ScheduleEngine
+ * @brief Недельные программы уставок, снижение и ручные переопределения по зонам.
+ *
+ * На каждую зону в колесе таймеров лежит не больше двух событий: следующее
+ * переключение программы и конец переопределения. Сработавшие за период
+ * события сворачиваются в один SetpointBatch (последняя уставка зоны), так что
+ * владелец хранилища получает пакет, а не сигнал на событие.
+ */
+class ScheduleEngine {
+public:
+    using ProgramId = std::uint32_t;
+    static constexpr ProgramId kNoProgram = 0xFFFFFFFFu;
+
+    explicit ScheduleEngine(std::size_t zoneCount, ScheduleTime start = 0);
+
+    void resize(std::size_t zoneCount); // Новые зоны без программы
+
+    ProgramId addProgram(const SetpointProgram &program); // kNoProgram, если нет ни одной точки
+    bool assignProgram(ZoneStore::ZoneId zone, ProgramId program); // kNoProgram снимает программу
+    ProgramId programOf(ZoneStore::ZoneId zone) const { return zoneProgram[zone]; }
+
+    // Ручная уставка до момента until; 0 — до следующего переключения программы зоны
+    // (при смене программы срок пересчитывается по новой)
+    bool overrideZone(ZoneStore::ZoneId zone, double temperature, double humidity, ScheduleTime until = 0);
+    void clearOverride(ZoneStore::ZoneId zone); // Сразу вернуть уставку программы
+    bool isOverridden(ZoneStore::ZoneId zone) const { return zoneOverridden[zone] != 0; }
+
+    // Обрабатывает события до now включительно; batch заменяется уставками за период
+    std::size_t advance(ScheduleTime now, SetpointBatch &batch);
+
+    ScheduleTime now() const { return wheel.now(); }
+    std::size_t pendingEvents() const { return wheel.size(); }
+
+private:
+    enum class EventKind : std::uint8_t {
+        Transition,
+        OverrideEnd
+    };
+
+    struct Event {
+        ZoneStore::ZoneId zone = 0;
+        std::uint32_t transition = 0; // Индекс в CompiledProgram::transitions
+        EventKind kind = EventKind::Transition;
+    };
+
+    struct Transition {
+        std::uint32_t weekSecond;
+        ScheduleMode mode;
+    };
+
+    struct CompiledProgram {
+        SetpointProgram levels;
+        std::vector<Transition> transitions; // По возрастанию weekSecond, без повторов
+    };
+
+    using Wheel = TimerWheel<Event>;
+
+    std::uint32_t transitionAt(const CompiledProgram &program, ScheduleTime time) const; // Действующая в time
+    void scheduleTransition(ZoneStore::ZoneId zone, std::uint32_t transition, ScheduleTime when);
+    void scheduleOverrideEnd(ZoneStore::ZoneId zone, ScheduleTime until); // 0 — без срока
+    void emitProgramLevel(ZoneStore::ZoneId zone, ScheduleMode mode);
+    void emit(ZoneStore::ZoneId zone, double temperature, double humidity);
+
+    Wheel wheel;
+    std::vector<CompiledProgram> programs;
+    std::vector<Wheel::Fired> fired;
+
+    // Состояние зон (структура массивов)
+    std::vector<ProgramId> zoneProgram;
+    std::vector<Wheel::Handle> transitionHandle;
+    std::vector<ScheduleTime> nextTransitionTime;
+    std::vector<Wheel::Handle> overrideHandle;
+    std::vector<std::uint8_t> zoneOverridden;
+    std::vector<std::uint8_t> overrideToTransition; // Переопределение до переключения программы (until = 0)
+
+    SetpointBatch due;                    // Уставки, ещё не выданные advance()
+    std::vector<std::uint32_t> slotOfZone; // Позиция зоны в due (свёртка)
+};
+
+} // namespace hvac
+
+#endif // SCHEDULEENGINE_H
@@ -0,0 +1,115 @@
+#include "sensoringestion.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace hvac {
+
+void SensorBatch::clear() {
+    zones.clear();
+    temperature.clear();
+    humidity.clear();
+    pressure.clear();
+}
+
+void SensorBatch::reserve(std::size_t zoneCount) {
+    zones.reserve(zoneCount);
+    temperature.reserve(zoneCount);
+    humidity.reserve(zoneCount);
+    pressure.reserve(zoneCount);
+}
+
+void SensorBatch::applyTo(ZoneStore &store) const {
+    store.updateReadings(zones.data(), zones.size(), temperature.data(), humidity.data(), pressure.data());
+}
+
+SensorIngestion::SensorIngestion(std::size_t zoneCount, std::size_t queueCapacity)
+    : queue(queueCapacity), slotOfZone(zoneCount, kNoSlot) {}
+
+bool SensorIngestion::push(const SensorSample &sample) {
+    if (!queue.tryPush(sample)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+std::size_t SensorIngestion::drain(SensorBatch &batch, std::size_t maxSamples) {
+    batch.clear();
+    std::size_t taken = 0;
+    SensorSample sample;
+    while (taken < maxSamples && queue.tryPop(sample)) {
+        ++taken;
+        if (sample.zone >= slotOfZone.size()) {
+            continue; // Неизвестная зона
+        }
+        std::uint32_t &slot = slotOfZone[sample.zone];
+        if (slot == kNoSlot) {
+            slot = static_cast<std::uint32_t>(batch.zones.size());
+            batch.zones.push_back(sample.zone);
+            batch.temperature.push_back(sample.temperature);
+            batch.humidity.push_back(sample.humidity);
+            batch.pressure.push_back(sample.pressure);
+        } else {
+            batch.temperature[slot] = sample.temperature;
+            batch.humidity[slot] = sample.humidity;
+            batch.pressure[slot] = sample.pressure;
+        }
+    }
+    for (ZoneStore::ZoneId zone : batch.zones) {
+        slotOfZone[zone] = kNoSlot;
+    }
+    return taken;
+}
+
+SensorSimulator::SensorSimulator(SensorIngestion &ingestion, double samplesPerSecond)
+    : ingestion(ingestion), samplesPerSecond(samplesPerSecond) {}
+
+SensorSimulator::~SensorSimulator() {
+    stop();
+}
+
+void SensorSimulator::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    worker = std::thread(&SensorSimulator::run, this);
+}
+
+void SensorSimulator::stop() {
+    running.store(false);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SensorSimulator::run() {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto kTick = std::chrono::milliseconds(1);
+
+    const std::size_t zoneCount = ingestion.zoneCount();
+    const double samplesPerTick = samplesPerSecond / 1000.0;
+    double owed = 0;   // Дробный остаток показаний между тиками
+    std::uint64_t n = 0;
+    auto nextTick = Clock::now();
+
+    while (running.load(std::memory_order_relaxed) && zoneCount > 0) {
+        owed += samplesPerTick;
+        for (; owed >= 1.0; owed -= 1.0, ++n) {
+            // Медленные синусоиды со сдвигом фазы по зонам
+            const ZoneStore::ZoneId zone = static_cast<ZoneStore::ZoneId>(n % zoneCount);
+            const double phase = static_cast<double>(n) * 1e-4 + zone * 0.37;
+            SensorSample sample;
+            sample.zone = zone;
+            sample.temperature = 22.0 + 3.0 * std::sin(phase);
+            sample.humidity = 45.0 + 10.0 * std::sin(phase * 0.5);
+            sample.pressure = 101325.0 + 250.0 * std::sin(phase * 0.25);
+            ingestion.push(sample);
+            produced.fetch_add(1, std::memory_order_relaxed);
+        }
+        nextTick += kTick;
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+} // namespace hvac
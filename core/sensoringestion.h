@@ -0,0 +1,103 @@
+#ifndef SENSORINGESTION_H
+#define SENSORINGESTION_H
+
+#include "mpscring.h"
+#include "zonestore.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Одно показание датчика в базовых единицах (°C, %, Pa).
+ */
+struct SensorSample {
+    ZoneStore::ZoneId zone = 0;
+    double temperature = 0;
+    double humidity = 0;
+    double pressure = 0;
+};
+
+/**
+ * @brief Последние показания по зонам, накопленные за один период обновления.
+ *
+ * Столбцы совпадают с аргументами ZoneStore::updateReadings, поэтому пакет
+ * применяется к хранилищу одним вызовом.
+ */
+struct SensorBatch {
+    std::vector<ZoneStore::ZoneId> zones;
+    std::vector<double> temperature;
+    std::vector<double> humidity;
+    std::vector<double> pressure;
+
+    std::size_t size() const { return zones.size(); }
+    void clear();
+    void reserve(std::size_t zoneCount);
+    void applyTo(ZoneStore &store) const;
+};
+
+/**
+ * @class SensorIngestion
+ * @brief Приём показаний из потоков датчиков и их свёртка для потока GUI.
+ *
+ * Производители вызывают push() из любых потоков; поток GUI с заданной
+ * частотой вызывает drain() и получает по одному, последнему, показанию
+ * на зону. Переполнение очереди не блокирует датчики: лишние показания
+ * отбрасываются и учитываются в droppedCount().
+ */
+class SensorIngestion {
+public:
+    SensorIngestion(std::size_t zoneCount, std::size_t queueCapacity = 1 << 16);
+
+    bool push(const SensorSample &sample); // Потокобезопасно, без блокировок
+
+    // Забирает до maxSamples показаний и сворачивает их в batch (побеждает последнее)
+    std::size_t drain(SensorBatch &batch, std::size_t maxSamples = SIZE_MAX);
+
+    std::size_t zoneCount() const { return slotOfZone.size(); }
+    std::uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::uint32_t kNoSlot = UINT32_MAX;
+
+    MpscRing<SensorSample> queue;
+    std::vector<std::uint32_t> slotOfZone; // Позиция зоны в текущем пакете (только потребитель)
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+/**
+ * @class SensorSimulator
+ * @brief Поток-заменитель реальных датчиков для проверки приёма показаний.
+ *
+ * Генерирует плавно меняющиеся показания для всех зон с заданной частотой.
+ */
+class SensorSimulator {
+public:
+    SensorSimulator(SensorIngestion &ingestion, double samplesPerSecond);
+    ~SensorSimulator();
+
+    SensorSimulator(const SensorSimulator &) = delete;
+    SensorSimulator &operator=(const SensorSimulator &) = delete;
+
+    void start();
+    void stop();
+
+    std::uint64_t producedCount() const { return produced.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    SensorIngestion &ingestion;
+    double samplesPerSecond;
+    std::atomic<bool> running{false};
+    std::atomic<std::uint64_t> produced{0};
+    std::thread worker;
+};
+
+} // namespace hvac
+
+#endif // SENSORINGESTION_H
@@ -0,0 +1,148 @@
+#include "sessionprofile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace hvac {
+
+namespace {
+constexpr char kMagic[4] = {'H', 'V', 'P', 'F'};
+constexpr std::uint16_t kVersion = 1;
+constexpr std::uint16_t kMaxZones = 4096; // Профиль всегда остаётся маленьким
+
+/**
+ * @brief Заголовок файла профиля (20 байт), за ним zoneCount пар уставок и контрольная сумма.
+ */
+struct ProfileHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t zoneCount;
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint8_t theme;
+    std::uint8_t temperatureUnit;
+    std::uint8_t pressureUnit;
+    std::uint8_t reserved;
+    std::uint32_t selectedZone;
+};
+static_assert(sizeof(ProfileHeader) == 20, "ProfileHeader must stay 20 bytes");
+static_assert(sizeof(ProfileSetpoint) == 8, "ProfileSetpoint is stored as two floats");
+
+// FNV-1a: достаточно, чтобы отличить оборванную запись от целого файла
+std::uint32_t checksumOf(const unsigned char *data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+} // namespace
+
+void SessionProfile::captureSetpoints(const ZoneStore &store) {
+    const std::size_t count = std::min<std::size_t>(store.size(), kMaxZones);
+    setpoints.resize(count);
+    for (std::size_t zone = 0; zone < count; ++zone) {
+        const ZoneSnapshot snapshot = store.snapshot(static_cast<ZoneStore::ZoneId>(zone));
+        setpoints[zone].temperature = static_cast<float>(snapshot.setpointTemperature);
+        setpoints[zone].humidity = static_cast<float>(snapshot.setpointHumidity);
+    }
+}
+
+void SessionProfile::applySetpoints(ZoneStore &store) const {
+    const std::size_t count = std::min(setpoints.size(), store.size());
+    for (std::size_t zone = 0; zone < count; ++zone) {
+        store.setSetpoint(static_cast<ZoneStore::ZoneId>(zone), setpoints[zone].temperature,
+                          setpoints[zone].humidity);
+    }
+}
+
+bool loadSessionProfile(const std::string &path, SessionProfile &profile) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    // Файл крошечный: читаем целиком одним вызовом
+    std::vector<unsigned char> buffer(sizeof(ProfileHeader) + kMaxZones * sizeof(ProfileSetpoint) + sizeof(std::uint32_t));
+    const std::size_t size = std::fread(buffer.data(), 1, buffer.size(), file);
+    const unsigned char *data = buffer.data();
+    std::fclose(file);
+
+    if (size < sizeof(ProfileHeader) + sizeof(std::uint32_t)) {
+        return false;
+    }
+    ProfileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.zoneCount > kMaxZones) {
+        return false;
+    }
+    const std::size_t payload = sizeof(ProfileHeader) + header.zoneCount * sizeof(ProfileSetpoint);
+    if (size != payload + sizeof(std::uint32_t)) {
+        return false;
+    }
+    std::uint32_t storedChecksum;
+    std::memcpy(&storedChecksum, data + payload, sizeof(storedChecksum));
+    if (storedChecksum != checksumOf(data, payload)) {
+        return false;
+    }
+    if (header.theme > static_cast<std::uint8_t>(Theme::Dark) ||
+        header.temperatureUnit > static_cast<std::uint8_t>(TemperatureUnit::Kelvin) ||
+        header.pressureUnit > static_cast<std::uint8_t>(PressureUnit::MmHg) ||
+        header.width == 0 || header.height == 0) {
+        return false;
+    }
+
+    profile.width = header.width;
+    profile.height = header.height;
+    profile.theme = static_cast<Theme>(header.theme);
+    profile.temperatureUnit = static_cast<TemperatureUnit>(header.temperatureUnit);
+    profile.pressureUnit = static_cast<PressureUnit>(header.pressureUnit);
+    profile.selectedZone = header.selectedZone;
+    profile.setpoints.resize(header.zoneCount);
+    std::memcpy(profile.setpoints.data(), data + sizeof(ProfileHeader), header.zoneCount * sizeof(ProfileSetpoint));
+    return true;
+}
+
+bool saveSessionProfile(const std::string &path, const SessionProfile &profile) {
+    if (profile.setpoints.size() > kMaxZones) {
+        return false;
+    }
+    ProfileHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.zoneCount = static_cast<std::uint16_t>(profile.setpoints.size());
+    header.width = profile.width;
+    header.height = profile.height;
+    header.theme = static_cast<std::uint8_t>(profile.theme);
+    header.temperatureUnit = static_cast<std::uint8_t>(profile.temperatureUnit);
+    header.pressureUnit = static_cast<std::uint8_t>(profile.pressureUnit);
+    header.selectedZone = profile.selectedZone;
+
+    std::vector<unsigned char> data(sizeof(header) + profile.setpoints.size() * sizeof(ProfileSetpoint));
+    std::memcpy(data.data(), &header, sizeof(header));
+    if (!profile.setpoints.empty()) {
+        std::memcpy(data.data() + sizeof(header), profile.setpoints.data(),
+                    profile.setpoints.size() * sizeof(ProfileSetpoint));
+    }
+    const std::uint32_t checksum = checksumOf(data.data(), data.size());
+
+    const std::string temporaryPath = path + ".tmp";
+    std::FILE *file = std::fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size() &&
+                   std::fwrite(&checksum, sizeof(checksum), 1, file) == 1;
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename на Windows не заменяет существующий файл
+#endif
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+} // namespace hvac
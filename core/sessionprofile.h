@@ -0,0 +1,55 @@
+#ifndef SESSIONPROFILE_H
+#define SESSIONPROFILE_H
+
+#include "units.h"
+#include "zonestore.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Тема оформления окна.
+ */
+enum class Theme : std::uint8_t {
+    Light = 0,
+    Dark = 1
+};
+
+/**
+ * @brief Уставки одной зоны в профиле сеанса.
+ */
+struct ProfileSetpoint {
+    float temperature = 22.0f; // °C
+    float humidity = 45.0f;    // %
+};
+
+/**
+ * @brief Последний сеанс: разрешение, тема, единицы и уставки зон.
+ *
+ * Хранится в маленьком двоичном файле, чтобы при перезагрузке панели
+ * пропустить выбор разрешения и сразу показать окно.
+ */
+struct SessionProfile {
+    std::uint16_t width = 1024;
+    std::uint16_t height = 768;
+    Theme theme = Theme::Light;
+    TemperatureUnit temperatureUnit = TemperatureUnit::Celsius;
+    PressureUnit pressureUnit = PressureUnit::Pascal;
+    ZoneStore::ZoneId selectedZone = 0;
+    std::vector<ProfileSetpoint> setpoints; // По зонам
+
+    void captureSetpoints(const ZoneStore &store); // Уставки всех зон из хранилища
+    void applySetpoints(ZoneStore &store) const;   // Уставки в хранилище (лишние зоны профиля пропускаются)
+};
+
+// Чтение профиля; false, если файла нет или он повреждён (профиль при этом не меняется)
+bool loadSessionProfile(const std::string &path, SessionProfile &profile);
+// Запись через временный файл, чтобы сбой питания не оставил полузаписанный профиль
+bool saveSessionProfile(const std::string &path, const SessionProfile &profile);
+
+} // namespace hvac
+
+#endif // SESSIONPROFILE_H
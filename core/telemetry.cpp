@@ -0,0 +1,476 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hvac {
+
+namespace {
+constexpr char kMagic[4] = {'H', 'V', 'T', 'L'};
+constexpr std::uint16_t kVersion = 2;
+constexpr std::uint16_t kFirstVersion = 1; // Без записей Segment; читается и дописывается
+constexpr std::uint32_t kMaxZone = (1u << 24) - 1;
+constexpr std::size_t kBufferRecords = 4096;              // 64 КБ на запись в файл
+constexpr auto kIdleFlushInterval = std::chrono::milliseconds(250);
+
+// Фиксированная точка: температура и влажность в сотых, давление в десятых паскаля
+constexpr double kTemperatureScale = 100.0;
+constexpr double kHumidityScale = 100.0;
+constexpr double kPressureScale = 10.0;
+
+std::int64_t toFixed(double value, double scale) {
+    return std::llround(value * scale);
+}
+
+// Приращение, ограниченное разрядностью поля записи
+template <typename Field>
+Field deltaOf(std::int64_t &previous, std::int64_t value) {
+    const std::int64_t low = std::numeric_limits<Field>::min();
+    const std::int64_t high = std::numeric_limits<Field>::max();
+    const std::int64_t delta = std::min(std::max(value - previous, low), high);
+    previous += delta; // Читатель восстановит ровно это значение
+    return static_cast<Field>(delta);
+}
+
+std::uint32_t packZoneAndType(ZoneStore::ZoneId zone, TelemetryType type) {
+    return (zone & kMaxZone) | (static_cast<std::uint32_t>(type) << 24);
+}
+
+// Служебная запись с 64-битным временем (TimeJump, Segment)
+TelemetryRecord wideTimeRecord(TelemetryType type, std::int64_t timeMs) {
+    TelemetryRecord record = {};
+    record.zoneAndType = packZoneAndType(0, type);
+    record.timeDeltaMs = static_cast<std::uint32_t>(timeMs & 0xffffffffu);
+    record.c = static_cast<std::int32_t>(timeMs >> 32);
+    return record;
+}
+
+std::int64_t wideTimeOf(const TelemetryRecord &record) {
+    return (static_cast<std::int64_t>(record.c) << 32) | record.timeDeltaMs;
+}
+
+// Журналы растут дольше 2 ГБ, поэтому позиция 64-битная
+bool seekFile(std::FILE *file, std::int64_t offset, int origin) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, origin) == 0;
+#else
+    return ::fseeko(file, static_cast<off_t>(offset), origin) == 0;
+#endif
+}
+
+std::int64_t tellFile(std::FILE *file) {
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return static_cast<std::int64_t>(::ftello(file));
+#endif
+}
+} // namespace
+
+std::int64_t telemetryNowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+TelemetryWriter::TelemetryWriter(const std::string &path, std::size_t queueCapacity)
+    : queue(queueCapacity) {
+    const std::int64_t nowMs = telemetryNowMs();
+    buffer.reserve(kBufferRecords);
+
+    // Журнал прошлых сеансов не затираем, а дописываем
+    file = std::fopen(path.c_str(), "r+b");
+    std::int64_t size = 0;
+    if (file != nullptr && (!seekFile(file, 0, SEEK_END) || (size = tellFile(file)) < 0)) {
+        std::fclose(file);
+        file = nullptr;
+        return;
+    }
+    if (file == nullptr || size == 0) {
+        if (file == nullptr) {
+            file = std::fopen(path.c_str(), "wb");
+            if (file == nullptr) {
+                return;
+            }
+        }
+        TelemetryHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.recordSize = sizeof(TelemetryRecord);
+        header.baseTimeMs = nowMs;
+        std::fwrite(&header, sizeof(header), 1, file);
+    } else {
+        TelemetryHeader header;
+        const bool valid = size >= static_cast<std::int64_t>(sizeof(header)) && seekFile(file, 0, SEEK_SET) &&
+                           std::fread(&header, sizeof(header), 1, file) == 1 &&
+                           std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                           header.version >= kFirstVersion && header.version <= kVersion &&
+                           header.recordSize == sizeof(TelemetryRecord);
+        if (!valid) {
+            std::fclose(file); // Чужой или повреждённый файл не трогаем
+            file = nullptr;
+            return;
+        }
+        if (header.version < kVersion) {
+            // Старый журнал: дальше пойдут записи Segment, которых читатель версии 1 не знает
+            header.version = kVersion;
+            seekFile(file, 0, SEEK_SET);
+            std::fwrite(&header, sizeof(header), 1, file);
+        }
+        // Оборванная последняя запись прошлого сеанса перезаписывается новыми
+        const std::int64_t records = (size - static_cast<std::int64_t>(sizeof(header))) / sizeof(TelemetryRecord);
+        if (!seekFile(file, static_cast<std::int64_t>(sizeof(header)) + records * sizeof(TelemetryRecord),
+                      SEEK_SET)) {
+            std::fclose(file);
+            file = nullptr;
+            return;
+        }
+        // Читатель сбрасывает время и значения зон, поэтому приращения сеанса считаются с нуля
+        buffer.push_back(wideTimeRecord(TelemetryType::Segment, nowMs));
+    }
+    lastTimeMs = nowMs;
+
+    running.store(true);
+    worker = std::thread(&TelemetryWriter::run, this);
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+bool TelemetryWriter::log(const TelemetryEvent &event) {
+    if (!running.load(std::memory_order_relaxed) || !queue.tryPush(event)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool TelemetryWriter::logReading(ZoneStore::ZoneId zone, double temperature, double humidity, double pressure) {
+    TelemetryEvent event;
+    event.type = TelemetryType::Reading;
+    event.zone = zone;
+    event.timestampMs = telemetryNowMs();
+    event.values[0] = temperature;
+    event.values[1] = humidity;
+    event.values[2] = pressure;
+    return log(event);
+}
+
+bool TelemetryWriter::logSetpoint(ZoneStore::ZoneId zone, double temperature, double humidity) {
+    TelemetryEvent event;
+    event.type = TelemetryType::Setpoint;
+    event.zone = zone;
+    event.timestampMs = telemetryNowMs();
+    event.values[0] = temperature;
+    event.values[1] = humidity;
+    return log(event);
+}
+
+bool TelemetryWriter::logACStatus(ZoneStore::ZoneId zone, bool on) {
+    TelemetryEvent event;
+    event.type = TelemetryType::ACStatus;
+    event.zone = zone;
+    event.timestampMs = telemetryNowMs();
+    event.values[0] = on ? 1.0 : 0.0;
+    return log(event);
+}
+
+bool TelemetryWriter::logLouver(ZoneStore::ZoneId zone, int pan, int tilt) {
+    TelemetryEvent event;
+    event.type = TelemetryType::Louver;
+    event.zone = zone;
+    event.timestampMs = telemetryNowMs();
+    event.values[0] = pan;
+    event.values[1] = tilt;
+    return log(event);
+}
+
+void TelemetryWriter::close() {
+    running.store(false);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+void TelemetryWriter::run() {
+    auto lastFlush = std::chrono::steady_clock::now();
+    TelemetryEvent event;
+    for (;;) {
+        const bool stopping = !running.load(std::memory_order_acquire);
+        bool any = false;
+        while (queue.tryPop(event)) {
+            encode(event);
+            any = true;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (stopping || (!buffer.empty() && now - lastFlush >= kIdleFlushInterval)) {
+            flushBuffer();
+            lastFlush = now;
+        }
+        if (stopping) {
+            break;
+        }
+        if (!any) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+void TelemetryWriter::encode(const TelemetryEvent &event) {
+    if (event.zone > kMaxZone) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (event.zone >= zoneStates.size()) {
+        zoneStates.resize(event.zone + 1);
+    }
+    TelemetryZoneState &state = zoneStates[event.zone];
+
+    TelemetryRecord record = {};
+    record.zoneAndType = packZoneAndType(event.zone, event.type);
+    switch (event.type) {
+    case TelemetryType::Reading:
+        record.a = deltaOf<std::int16_t>(state.temperature, toFixed(event.values[0], kTemperatureScale));
+        record.b = deltaOf<std::int16_t>(state.humidity, toFixed(event.values[1], kHumidityScale));
+        record.c = deltaOf<std::int32_t>(state.pressure, toFixed(event.values[2], kPressureScale));
+        if (record.a == 0 && record.b == 0 && record.c == 0) {
+            return; // Ничего не изменилось — запись не нужна
+        }
+        break;
+    case TelemetryType::Setpoint:
+        record.a = deltaOf<std::int16_t>(state.setpointTemperature, toFixed(event.values[0], kTemperatureScale));
+        record.b = deltaOf<std::int16_t>(state.setpointHumidity, toFixed(event.values[1], kHumidityScale));
+        break;
+    case TelemetryType::ACStatus:
+        record.a = event.values[0] != 0 ? 1 : 0;
+        break;
+    case TelemetryType::Louver:
+        record.a = deltaOf<std::int16_t>(state.pan, std::llround(event.values[0]));
+        record.b = deltaOf<std::int16_t>(state.tilt, std::llround(event.values[1]));
+        break;
+    case TelemetryType::TimeJump:
+    case TelemetryType::Segment:
+        return; // Служебные записи создаёт только кодировщик
+    }
+
+    std::int64_t delta = std::max<std::int64_t>(event.timestampMs - lastTimeMs, 0);
+    if (delta > UINT32_MAX) {
+        buffer.push_back(wideTimeRecord(TelemetryType::TimeJump, delta));
+        delta = 0;
+    }
+    lastTimeMs = std::max(lastTimeMs, event.timestampMs);
+    record.timeDeltaMs = static_cast<std::uint32_t>(delta);
+    buffer.push_back(record);
+
+    if (buffer.size() >= kBufferRecords) {
+        flushBuffer();
+    }
+}
+
+void TelemetryWriter::flushBuffer() {
+    if (file == nullptr || buffer.empty()) {
+        return;
+    }
+    std::fwrite(buffer.data(), sizeof(TelemetryRecord), buffer.size(), file);
+    std::fflush(file);
+    buffer.clear();
+}
+
+TelemetryReader::~TelemetryReader() {
+    close();
+}
+
+bool TelemetryReader::open(const std::string &path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(TelemetryHeader))) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE mappingObject = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingObject == nullptr) {
+        CloseHandle(handle);
+        return false;
+    }
+    mapping = MapViewOfFile(mappingObject, FILE_MAP_READ, 0, 0, 0);
+    if (mapping == nullptr) {
+        CloseHandle(mappingObject);
+        CloseHandle(handle);
+        return false;
+    }
+    fileHandle = handle;
+    mappingHandle = mappingObject;
+    mappingSize = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(TelemetryHeader))) {
+        ::close(descriptor);
+        return false;
+    }
+    void *address = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor); // Отображение остаётся действительным после закрытия дескриптора
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mapping = address;
+    mappingSize = static_cast<std::size_t>(status.st_size);
+#endif
+
+    const auto *header = static_cast<const TelemetryHeader *>(mapping);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version < kFirstVersion
+        || header->version > kVersion || header->recordSize != sizeof(TelemetryRecord)) {
+        close();
+        return false;
+    }
+    baseTime = header->baseTimeMs;
+    first = reinterpret_cast<const TelemetryRecord *>(static_cast<const char *>(mapping) + sizeof(TelemetryHeader));
+    // Неполная последняя запись (обрыв записи) отбрасывается
+    count = (mappingSize - sizeof(TelemetryHeader)) / sizeof(TelemetryRecord);
+    return true;
+}
+
+void TelemetryReader::close() {
+    if (mapping != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        ::munmap(const_cast<void *>(mapping), mappingSize);
+#endif
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    first = nullptr;
+    count = 0;
+    baseTime = 0;
+}
+
+TelemetryReader::Cursor::Cursor(const TelemetryReader &reader)
+    : current(reader.records()), end(reader.records() + reader.recordCount()), timeMs(reader.baseTimeMs()) {}
+
+bool TelemetryReader::Cursor::next(TelemetryEvent &event) {
+    while (current != end) {
+        const TelemetryRecord &record = *current++;
+        const auto type = static_cast<TelemetryType>(record.zoneAndType >> 24);
+        const ZoneStore::ZoneId zone = record.zoneAndType & kMaxZone;
+
+        if (type == TelemetryType::TimeJump) {
+            timeMs += wideTimeOf(record);
+            continue;
+        }
+        if (type == TelemetryType::Segment) {
+            // Новый сеанс записи: абсолютное время, приращения значений снова от нуля
+            timeMs = wideTimeOf(record);
+            zoneStates.assign(zoneStates.size(), TelemetryZoneState());
+            continue;
+        }
+        timeMs += record.timeDeltaMs;
+
+        if (zone >= zoneStates.size()) {
+            zoneStates.resize(zone + 1);
+        }
+        TelemetryZoneState &state = zoneStates[zone];
+        event.type = type;
+        event.zone = zone;
+        event.timestampMs = timeMs;
+        event.values[0] = event.values[1] = event.values[2] = 0;
+
+        switch (type) {
+        case TelemetryType::Reading:
+            state.temperature += record.a;
+            state.humidity += record.b;
+            state.pressure += record.c;
+            event.values[0] = state.temperature / kTemperatureScale;
+            event.values[1] = state.humidity / kHumidityScale;
+            event.values[2] = state.pressure / kPressureScale;
+            return true;
+        case TelemetryType::Setpoint:
+            state.setpointTemperature += record.a;
+            state.setpointHumidity += record.b;
+            event.values[0] = state.setpointTemperature / kTemperatureScale;
+            event.values[1] = state.setpointHumidity / kHumidityScale;
+            return true;
+        case TelemetryType::ACStatus:
+            event.values[0] = record.a;
+            return true;
+        case TelemetryType::Louver:
+            state.pan += record.a;
+            state.tilt += record.b;
+            event.values[0] = static_cast<double>(state.pan);
+            event.values[1] = static_cast<double>(state.tilt);
+            return true;
+        default:
+            break; // Неизвестный тип из более новой версии — пропускаем
+        }
+    }
+    return false;
+}
+
+void applyTelemetryEvent(ZoneStore &store, const TelemetryEvent &event) {
+    if (event.zone >= store.size()) {
+        return;
+    }
+    switch (event.type) {
+    case TelemetryType::Reading:
+        store.setReading(event.zone, event.values[0], event.values[1], event.values[2]);
+        break;
+    case TelemetryType::Setpoint:
+        store.setSetpoint(event.zone, event.values[0], event.values[1]);
+        break;
+    case TelemetryType::ACStatus:
+        store.setACStatus(event.zone, event.values[0] != 0);
+        break;
+    case TelemetryType::Louver:
+        store.setLouver(event.zone, static_cast<std::int16_t>(event.values[0]),
+                        static_cast<std::int16_t>(event.values[1]));
+        break;
+    case TelemetryType::TimeJump:
+    case TelemetryType::Segment:
+        break;
+    }
+}
+
+std::size_t replayTelemetry(const TelemetryReader &reader, ZoneStore &store, std::int64_t untilMs) {
+    TelemetryReader::Cursor cursor(reader);
+    TelemetryEvent event;
+    std::size_t applied = 0;
+    while (cursor.next(event) && event.timestampMs <= untilMs) {
+        applyTelemetryEvent(store, event);
+        ++applied;
+    }
+    return applied;
+}
+
+} // namespace hvac
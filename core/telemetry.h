@@ -0,0 +1,186 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "mpscring.h"
+#include "zonestore.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Тип события телеметрии.
+ */
+enum class TelemetryType : std::uint8_t {
+    Reading = 1,  // Показания: температура, влажность, давление
+    Setpoint = 2, // Уставки: температура, влажность
+    ACStatus = 3, // Включение/выключение кондиционера
+    Louver = 4,   // Углы жалюзи: горизонтальный, вертикальный
+    TimeJump = 5, // Служебная: пропуск времени длиннее 32 бит миллисекунд
+    Segment = 6   // Служебная: начало дописанного сеанса — абсолютное время, значения зон с нуля
+};
+
+/**
+ * @brief Раскодированное событие телеметрии в базовых единицах.
+ */
+struct TelemetryEvent {
+    TelemetryType type = TelemetryType::Reading;
+    ZoneStore::ZoneId zone = 0;
+    std::int64_t timestampMs = 0; // Миллисекунды от эпохи Unix
+    double values[3] = {0, 0, 0}; // Смысл зависит от type (см. TelemetryType)
+};
+
+/**
+ * @brief Запись файла телеметрии фиксированного размера (16 байт, little-endian).
+ *
+ * Время хранится как приращение к предыдущей записи, значения — как
+ * приращения к предыдущему значению того же поля той же зоны в фиксированной
+ * точке: температура и влажность в сотых, давление в десятых паскаля.
+ * TimeJump и Segment несут 64-битное время: младшие 32 бита в timeDeltaMs,
+ * старшие в c.
+ */
+struct TelemetryRecord {
+    std::uint32_t timeDeltaMs;  // Приращение времени к предыдущей записи
+    std::uint32_t zoneAndType;  // Младшие 24 бита — зона, старшие 8 — TelemetryType
+    std::int16_t a;             // Температура / угол по горизонтали / статус
+    std::int16_t b;             // Влажность / угол по вертикали
+    std::int32_t c;             // Давление
+};
+static_assert(sizeof(TelemetryRecord) == 16, "TelemetryRecord must stay 16 bytes");
+
+/**
+ * @brief Заголовок файла телеметрии (32 байта).
+ */
+struct TelemetryHeader {
+    char magic[4];            // "HVTL"
+    std::uint16_t version;    // Версия формата (2 — с записями Segment)
+    std::uint16_t recordSize; // sizeof(TelemetryRecord)
+    std::int64_t baseTimeMs;  // Время, от которого отсчитывается первая запись
+    std::uint8_t reserved[16];
+};
+static_assert(sizeof(TelemetryHeader) == 32, "TelemetryHeader must stay 32 bytes");
+
+/**
+ * @brief Последние значения полей зоны в фиксированной точке, от которых считаются приращения.
+ */
+struct TelemetryZoneState {
+    std::int64_t temperature = 0;
+    std::int64_t humidity = 0;
+    std::int64_t pressure = 0;
+    std::int64_t setpointTemperature = 0;
+    std::int64_t setpointHumidity = 0;
+    std::int64_t pan = 0;
+    std::int64_t tilt = 0;
+};
+
+std::int64_t telemetryNowMs(); // Текущее время для отметок событий
+
+/**
+ * @class TelemetryWriter
+ * @brief Пишет события в двоичный журнал из фонового потока.
+ *
+ * Вызовы log*() только кладут событие в lock-free очередь и не ждут диска;
+ * фоновый поток кодирует приращения и пишет буферами. Показания, не
+ * изменившиеся с точностью записи, не пишутся вовсе.
+ *
+ * Существующий журнал дописывается: заголовок проверяется (чужой файл не
+ * открывается и не портится), оборванная последняя запись перезаписывается,
+ * а сеанс начинается записью Segment, от которой приращения считаются заново.
+ */
+class TelemetryWriter {
+public:
+    explicit TelemetryWriter(const std::string &path, std::size_t queueCapacity = 1 << 14);
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter &) = delete;
+    TelemetryWriter &operator=(const TelemetryWriter &) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    bool log(const TelemetryEvent &event);
+    bool logReading(ZoneStore::ZoneId zone, double temperature, double humidity, double pressure);
+    bool logSetpoint(ZoneStore::ZoneId zone, double temperature, double humidity);
+    bool logACStatus(ZoneStore::ZoneId zone, bool on);
+    bool logLouver(ZoneStore::ZoneId zone, int pan, int tilt);
+
+    void close(); // Дописывает очередь и закрывает файл
+
+    std::uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void encode(const TelemetryEvent &event);
+    void flushBuffer();
+
+    std::FILE *file = nullptr;
+    MpscRing<TelemetryEvent> queue;
+    std::atomic<bool> running{false};
+    std::atomic<std::uint64_t> dropped{0};
+    std::thread worker;
+
+    // Доступны только фоновому потоку
+    std::int64_t lastTimeMs = 0;
+    std::vector<TelemetryZoneState> zoneStates;
+    std::vector<TelemetryRecord> buffer;
+};
+
+/**
+ * @class TelemetryReader
+ * @brief Отображает файл телеметрии в память и раскодирует записи без копирования файла.
+ */
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader &) = delete;
+    TelemetryReader &operator=(const TelemetryReader &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    std::size_t recordCount() const { return count; }
+    const TelemetryRecord *records() const { return first; } // Записи прямо из отображённого файла
+    std::int64_t baseTimeMs() const { return baseTime; }
+
+    /**
+     * @brief Последовательное раскодирование записей с восстановлением значений.
+     */
+    class Cursor {
+    public:
+        explicit Cursor(const TelemetryReader &reader);
+        bool next(TelemetryEvent &event);
+
+    private:
+        const TelemetryRecord *current;
+        const TelemetryRecord *end;
+        std::int64_t timeMs;
+        std::vector<TelemetryZoneState> zoneStates;
+    };
+
+private:
+    const void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+    const TelemetryRecord *first = nullptr;
+    std::size_t count = 0;
+    std::int64_t baseTime = 0;
+};
+
+void applyTelemetryEvent(ZoneStore &store, const TelemetryEvent &event);
+
+// Проигрывает журнал в хранилище до момента untilMs включительно; возвращает число событий
+std::size_t replayTelemetry(const TelemetryReader &reader, ZoneStore &store, std::int64_t untilMs = INT64_MAX);
+
+} // namespace hvac
+
+#endif // TELEMETRY_H
@@ -0,0 +1,134 @@
+#include "thermalsim.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hvac {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kSecondsPerDay = 86400.0;
+constexpr double kSecondsPerYear = 365.0 * kSecondsPerDay;
+
+double clamp(double value, double low, double high) {
+    return std::min(std::max(value, low), high);
+}
+} // namespace
+
+double ClimateProfile::outdoorTemperature(double seconds) const {
+    // Минимум года в середине января, минимум суток около 4 утра
+    const double annual = std::cos(2.0 * kPi * (seconds / kSecondsPerYear - 15.0 / 365.0));
+    const double daily = std::cos(2.0 * kPi * (seconds / kSecondsPerDay - 4.0 / 24.0));
+    return meanTemperature - annualAmplitude * annual - dailyAmplitude * daily;
+}
+
+SimulationEngine::SimulationEngine(ZoneStore &store, double timeStep)
+    : store(store), dt(timeStep) {
+    syncZoneCount();
+}
+
+void SimulationEngine::syncZoneCount() {
+    const std::size_t zoneCount = store.size();
+    const ZoneThermalParameters defaults;
+    thermalCapacity.resize(zoneCount, defaults.thermalCapacity);
+    lossCoefficient.resize(zoneCount, defaults.lossCoefficient);
+    internalGain.resize(zoneCount, defaults.internalGain);
+    hvacPower.resize(zoneCount, defaults.hvacPower);
+    humidityTimeConstant.resize(zoneCount, defaults.humidityTimeConstant);
+    dehumidifyRate.resize(zoneCount, defaults.dehumidifyRate);
+    temperatureIntegral.resize(zoneCount, 0.0);
+    temperaturePreviousError.resize(zoneCount, 0.0);
+    humidityIntegral.resize(zoneCount, 0.0);
+    energyUsed.resize(zoneCount, 0.0);
+}
+
+void SimulationEngine::setZoneParameters(ZoneStore::ZoneId zone, const ZoneThermalParameters &parameters) {
+    thermalCapacity[zone] = parameters.thermalCapacity;
+    lossCoefficient[zone] = parameters.lossCoefficient;
+    internalGain[zone] = parameters.internalGain;
+    hvacPower[zone] = parameters.hvacPower;
+    humidityTimeConstant[zone] = parameters.humidityTimeConstant;
+    dehumidifyRate[zone] = parameters.dehumidifyRate;
+}
+
+void SimulationEngine::setAllZoneParameters(const ZoneThermalParameters &parameters) {
+    std::fill(thermalCapacity.begin(), thermalCapacity.end(), parameters.thermalCapacity);
+    std::fill(lossCoefficient.begin(), lossCoefficient.end(), parameters.lossCoefficient);
+    std::fill(internalGain.begin(), internalGain.end(), parameters.internalGain);
+    std::fill(hvacPower.begin(), hvacPower.end(), parameters.hvacPower);
+    std::fill(humidityTimeConstant.begin(), humidityTimeConstant.end(), parameters.humidityTimeConstant);
+    std::fill(dehumidifyRate.begin(), dehumidifyRate.end(), parameters.dehumidifyRate);
+}
+
+void SimulationEngine::reset(double startTime) {
+    simulationTime = startTime;
+    pendingTime = 0;
+    std::fill(temperatureIntegral.begin(), temperatureIntegral.end(), 0.0);
+    std::fill(temperaturePreviousError.begin(), temperaturePreviousError.end(), 0.0);
+    std::fill(humidityIntegral.begin(), humidityIntegral.end(), 0.0);
+    std::fill(energyUsed.begin(), energyUsed.end(), 0.0);
+}
+
+void SimulationEngine::step() {
+    step(climate.outdoorTemperature(simulationTime), 1.0);
+}
+
+void SimulationEngine::step(double outdoorTemperature, double loadFactor) {
+    const std::size_t zoneCount = std::min(store.size(), thermalCapacity.size());
+    const double outdoorHumidity = climate.humidity;
+
+    double *temperature = store.temperatures();
+    double *humidity = store.humidities();
+    const double *setpointTemperature = store.setpointTemperatures();
+    const double *setpointHumidity = store.setpointHumidities();
+    const std::uint8_t *acStatus = store.acStatuses();
+
+    // Интегралы ограничены так, чтобы одна I-составляющая не выходила за [-1, 1]
+    const double temperatureIntegralLimit = temperatureGains.ki > 0 ? 1.0 / temperatureGains.ki : 0.0;
+    const double humidityIntegralLimit = humidityGains.ki > 0 ? 1.0 / humidityGains.ki : 0.0;
+
+    for (std::size_t i = 0; i < zoneCount; ++i) {
+        const double on = acStatus[i] ? 1.0 : 0.0;
+
+        // Температура: положительная ошибка — жарко, регулятор охлаждает
+        const double error = temperature[i] - setpointTemperature[i];
+        temperatureIntegral[i] =
+            on * clamp(temperatureIntegral[i] + error * dt, -temperatureIntegralLimit, temperatureIntegralLimit);
+        const double derivative = (error - temperaturePreviousError[i]) / dt;
+        temperaturePreviousError[i] = error;
+        const double output = on * clamp(temperatureGains.kp * error + temperatureGains.ki * temperatureIntegral[i]
+                                             + temperatureGains.kd * derivative,
+                                         -1.0, 1.0);
+
+        const double heatFlow = lossCoefficient[i] * (outdoorTemperature - temperature[i]) + loadFactor * internalGain[i]
+                                - output * hvacPower[i];
+        temperature[i] += heatFlow / thermalCapacity[i] * dt;
+        energyUsed[i] += std::fabs(output) * hvacPower[i] * dt;
+
+        // Влажность: кондиционер только осушает
+        const double humidityError = humidity[i] - setpointHumidity[i];
+        humidityIntegral[i] =
+            on * clamp(humidityIntegral[i] + humidityError * dt, -humidityIntegralLimit, humidityIntegralLimit);
+        const double dehumidify = on * clamp(humidityGains.kp * humidityError + humidityGains.ki * humidityIntegral[i],
+                                             0.0, 1.0);
+        humidity[i] += ((outdoorHumidity - humidity[i]) / humidityTimeConstant[i] - dehumidify * dehumidifyRate[i]) * dt;
+        humidity[i] = clamp(humidity[i], 0.0, 100.0);
+    }
+    simulationTime += dt;
+}
+
+std::uint64_t SimulationEngine::run(std::uint64_t steps) {
+    for (std::uint64_t i = 0; i < steps; ++i) {
+        step();
+    }
+    return steps;
+}
+
+std::uint64_t SimulationEngine::advance(double seconds) {
+    pendingTime += seconds;
+    const std::uint64_t steps = static_cast<std::uint64_t>(pendingTime / dt);
+    pendingTime -= static_cast<double>(steps) * dt;
+    return run(steps);
+}
+
+} // namespace hvac
@@ -0,0 +1,105 @@
+#ifndef THERMALSIM_H
+#define THERMALSIM_H
+
+#include "zonestore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Коэффициенты ПИД-регулятора. Выход регулятора ограничен [-1, 1].
+ */
+struct PidGains {
+    double kp = 0;
+    double ki = 0;
+    double kd = 0;
+};
+
+/**
+ * @brief Наружный климат: суточные и годовые колебания температуры.
+ */
+struct ClimateProfile {
+    double meanTemperature = 12.0;  // Среднегодовая температура, °C
+    double annualAmplitude = 12.0;  // Размах годовых колебаний, °C
+    double dailyAmplitude = 5.0;    // Размах суточных колебаний, °C
+    double humidity = 60.0;         // Наружная влажность, %
+
+    double outdoorTemperature(double seconds) const; // Время от начала года (1 января, 00:00)
+};
+
+/**
+ * @brief Тепловые параметры одной зоны.
+ */
+struct ZoneThermalParameters {
+    double thermalCapacity = 2.0e6;       // Теплоёмкость воздуха и обстановки, Дж/К
+    double lossCoefficient = 120.0;       // Теплообмен с улицей, Вт/К
+    double internalGain = 300.0;          // Люди и оборудование, Вт
+    double hvacPower = 3000.0;            // Мощность кондиционера (охлаждение и нагрев), Вт
+    double humidityTimeConstant = 7200.0; // Выравнивание влажности с улицей, с
+    double dehumidifyRate = 0.002;        // Осушение на полной мощности, %/с
+};
+
+/**
+ * @class SimulationEngine
+ * @brief Замкнутый контур: тепловая модель помещений и ПИД-регуляторы для всех зон.
+ *
+ * Работает прямо со столбцами ZoneStore: читает уставки и статус кондиционера,
+ * пишет температуру и влажность. Интегрирование явным методом Эйлера с
+ * фиксированным шагом; step() не выделяет память, поэтому год работы тысяч
+ * зон считается быстрее реального времени пакетом через run().
+ */
+class SimulationEngine {
+public:
+    explicit SimulationEngine(ZoneStore &store, double timeStep = 60.0);
+
+    void setTemperatureGains(const PidGains &gains) { temperatureGains = gains; }
+    void setHumidityGains(const PidGains &gains) { humidityGains = gains; }
+    void setClimate(const ClimateProfile &profile) { climate = profile; }
+    void setZoneParameters(ZoneStore::ZoneId zone, const ZoneThermalParameters &parameters);
+    void setAllZoneParameters(const ZoneThermalParameters &parameters);
+
+    // После ZoneStore::resize: единственное место, где меняется размер внутренних буферов
+    void syncZoneCount();
+    // Сброс регуляторов и счётчиков, время начинается с startTime
+    void reset(double startTime = 0.0);
+
+    void step();                            // Один шаг длиной timeStep
+    // Шаг по записанному профилю нагрузки: наружная температура и множитель внутренних теплопритоков
+    void step(double outdoorTemperature, double loadFactor);
+    std::uint64_t run(std::uint64_t steps); // Пакетный прогон
+    std::uint64_t advance(double seconds);  // Для реального времени: копит остаток меньше шага
+
+    double time() const { return simulationTime; }
+    double timeStep() const { return dt; }
+    void setTimeStep(double seconds) { dt = seconds; }
+    const double *energy() const { return energyUsed.data(); } // Затраты энергии по зонам, Дж
+
+private:
+    ZoneStore &store;
+    double dt;
+    double simulationTime = 0;
+    double pendingTime = 0;
+
+    PidGains temperatureGains{0.5, 0.0005, 0.0};
+    PidGains humidityGains{0.1, 0.0001, 0.0};
+    ClimateProfile climate;
+
+    // Параметры и состояние регуляторов по зонам (структура массивов)
+    std::vector<double> thermalCapacity;
+    std::vector<double> lossCoefficient;
+    std::vector<double> internalGain;
+    std::vector<double> hvacPower;
+    std::vector<double> humidityTimeConstant;
+    std::vector<double> dehumidifyRate;
+    std::vector<double> temperatureIntegral;
+    std::vector<double> temperaturePreviousError;
+    std::vector<double> humidityIntegral;
+    std::vector<double> energyUsed;
+};
+
+} // namespace hvac
+
+#endif // THERMALSIM_H
@@ -0,0 +1,254 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @class TimerWheel
+ * @brief Иерархическое колесо таймеров: вставка, отмена и срабатывание за O(1).
+ *
+ * 11 уровней по 64 ячейки покрывают все 64 бита тика; уровень l — интервалы
+ * по 64^l тиков. Событие кладётся на уровень старшего разряда, в котором его
+ * время отличается от текущего, и спускается ниже при проходе границы уровня.
+ * Узлы живут в общем пуле с двусвязными списками, поэтому после прогрева
+ * память не выделяется. Пустые участки времени пропускаются по битовым картам
+ * занятых ячеек.
+ */
+template <typename T>
+class TimerWheel {
+public:
+    using Tick = std::uint64_t;
+
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kSlots = 1u << kSlotBits;
+    static constexpr unsigned kLevels = (64 + kSlotBits - 1) / kSlotBits;
+
+    /**
+     * @brief Ссылка на запланированное событие для отмены.
+     */
+    struct Handle {
+        std::uint32_t index = kNone;
+        std::uint32_t generation = 0;
+        bool isValid() const { return index != kNone; }
+    };
+
+    /**
+     * @brief Сработавшее событие.
+     */
+    struct Fired {
+        Tick tick;
+        T payload;
+    };
+
+    explicit TimerWheel(Tick start = 0) : current(start) {
+        heads.fill(kNone);
+        tails.fill(kNone);
+        occupied.fill(0);
+    }
+
+    Tick now() const { return current; } // Следующий необработанный тик
+    std::size_t size() const { return active; }
+    void reserve(std::size_t events) { nodes.reserve(events); }
+
+    // Событие в прошлом сработает при ближайшем advance()
+    Handle schedule(Tick when, T payload) {
+        if (when < current) {
+            when = current;
+        }
+        std::uint32_t index;
+        if (freeList != kNone) {
+            index = freeList;
+            freeList = nodes[index].next;
+            nodes[index].payload = std::move(payload);
+        } else {
+            index = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(Node{std::move(payload)});
+        }
+        Node &node = nodes[index];
+        node.when = when;
+        node.live = true;
+        place(index);
+        ++active;
+        return Handle{index, node.generation};
+    }
+
+    bool cancel(Handle handle) {
+        if (handle.index >= nodes.size()) {
+            return false;
+        }
+        Node &node = nodes[handle.index];
+        if (!node.live || node.generation != handle.generation) {
+            return false;
+        }
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    // Обрабатывает все тики до until включительно; сработавшие события дописываются в out по порядку
+    std::size_t advance(Tick until, std::vector<Fired> &out) {
+        const std::size_t before = out.size();
+        while (current <= until) {
+            fireSlot(current, out);
+            const Tick next = nextEventTick();
+            moveTo(next <= until ? next : until + 1);
+        }
+        return out.size() - before;
+    }
+
+private:
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+    struct Node {
+        T payload;
+        Tick when = 0;
+        std::uint32_t next = kNone;
+        std::uint32_t prev = kNone;
+        std::uint32_t generation = 0;
+        std::uint16_t slot = 0; // Номер ячейки: уровень * kSlots + разряд
+        bool live = false;
+    };
+
+    static unsigned digitOf(Tick tick, unsigned level) {
+        return static_cast<unsigned>(tick >> (kSlotBits * level)) & (kSlots - 1);
+    }
+
+    static unsigned lowestBit(std::uint64_t bits) {
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+        unsigned result = 0;
+        while ((bits & 1) == 0) {
+            bits >>= 1;
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    static unsigned levelOf(Tick when, Tick now) {
+        Tick differing = when ^ now;
+        unsigned level = 0;
+        while ((differing >>= kSlotBits) != 0) {
+            ++level;
+        }
+        return level;
+    }
+
+    void place(std::uint32_t index) {
+        Node &node = nodes[index];
+        const unsigned level = levelOf(node.when, current);
+        const unsigned digit = digitOf(node.when, level);
+        const std::size_t slot = level * kSlots + digit;
+        node.slot = static_cast<std::uint16_t>(slot);
+        node.next = kNone;
+        node.prev = tails[slot];
+        if (tails[slot] != kNone) {
+            nodes[tails[slot]].next = index;
+        } else {
+            heads[slot] = index;
+        }
+        tails[slot] = index;
+        occupied[level] |= std::uint64_t(1) << digit;
+    }
+
+    void unlink(std::uint32_t index) {
+        Node &node = nodes[index];
+        const std::size_t slot = node.slot;
+        if (node.prev != kNone) {
+            nodes[node.prev].next = node.next;
+        } else {
+            heads[slot] = node.next;
+        }
+        if (node.next != kNone) {
+            nodes[node.next].prev = node.prev;
+        } else {
+            tails[slot] = node.prev;
+        }
+        if (heads[slot] == kNone) {
+            occupied[slot / kSlots] &= ~(std::uint64_t(1) << (slot % kSlots));
+        }
+    }
+
+    void release(std::uint32_t index) {
+        Node &node = nodes[index];
+        node.live = false;
+        ++node.generation; // Старые Handle больше не действуют
+        node.next = freeList;
+        freeList = index;
+        --active;
+    }
+
+    // Забирает список ячейки целиком
+    std::uint32_t detach(std::size_t slot) {
+        const std::uint32_t head = heads[slot];
+        heads[slot] = kNone;
+        tails[slot] = kNone;
+        occupied[slot / kSlots] &= ~(std::uint64_t(1) << (slot % kSlots));
+        return head;
+    }
+
+    void fireSlot(Tick tick, std::vector<Fired> &out) {
+        std::uint32_t index = detach(digitOf(tick, 0));
+        while (index != kNone) {
+            const std::uint32_t next = nodes[index].next;
+            out.push_back(Fired{tick, std::move(nodes[index].payload)});
+            release(index);
+            index = next;
+        }
+    }
+
+    // Ближайший тик после current, где что-то срабатывает или спускается с уровня выше
+    Tick nextEventTick() const {
+        Tick best = ~Tick(0);
+        for (unsigned level = 0; level < kLevels; ++level) {
+            const unsigned digit = digitOf(current, level);
+            const std::uint64_t ahead = digit + 1 < kSlots ? occupied[level] & (~std::uint64_t(0) << (digit + 1)) : 0;
+            if (ahead == 0) {
+                continue;
+            }
+            const unsigned slot = lowestBit(ahead);
+            const unsigned shift = kSlotBits * (level + 1);
+            const Tick base = shift < 64 ? (current >> shift) << shift : 0;
+            const Tick tick = base | (Tick(slot) << (kSlotBits * level));
+            best = tick < best ? tick : best;
+        }
+        return best;
+    }
+
+    void moveTo(Tick tick) {
+        current = tick;
+        // Сверху вниз: спущенное с уровня выше может сразу попасть в спускаемую ячейку ниже
+        for (unsigned level = kLevels - 1; level > 0; --level) {
+            const Tick lowMask = (Tick(1) << (kSlotBits * level)) - 1;
+            if ((tick & lowMask) != 0) {
+                continue;
+            }
+            // Ячейка текущего разряда уровня содержит ровно интервал [tick, tick + 64^level)
+            std::uint32_t index = detach(level * kSlots + digitOf(tick, level));
+            while (index != kNone) {
+                const std::uint32_t next = nodes[index].next;
+                place(index);
+                index = next;
+            }
+        }
+    }
+
+    Tick current;
+    std::vector<Node> nodes;
+    std::array<std::uint32_t, kLevels * kSlots> heads;
+    std::array<std::uint32_t, kLevels * kSlots> tails;
+    std::array<std::uint64_t, kLevels> occupied; // Битовые карты занятых ячеек по уровням
+    std::uint32_t freeList = kNone;
+    std::size_t active = 0;
+};
+
+} // namespace hvac
+
+#endif // TIMERWHEEL_H
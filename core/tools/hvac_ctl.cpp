@@ -0,0 +1,189 @@
+// Клиент протокола управления из командной строки: скрипты и проверка работающего окна.
+//
+//   hvac_ctl <сокет | порт> read <зона>
+//   hvac_ctl <сокет | порт> setpoint <зона> <°C> <%>
+//   hvac_ctl <сокет | порт> ac <зона> on|off|toggle
+//   hvac_ctl <сокет | порт> louver <зона> <горизонталь> <вертикаль>
+//   hvac_ctl <сокет | порт> poll <зона> <запросов>   — замер частоты опроса
+//
+// Число вместо пути к сокету означает порт на 127.0.0.1.
+
+#include "controlserver.h"
+#include "inputvalidation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char *statusName(std::uint8_t status) {
+    switch (static_cast<hvac::ControlStatus>(status)) {
+    case hvac::ControlStatus::Ok:
+        return "ok";
+    case hvac::ControlStatus::BadZone:
+        return "bad zone";
+    case hvac::ControlStatus::BadValue:
+        return "bad value";
+    case hvac::ControlStatus::UnknownOpcode:
+        return "unknown opcode";
+    case hvac::ControlStatus::Busy:
+        return "busy";
+    }
+    return "?";
+}
+
+void printResponse(const hvac::ControlResponse &response) {
+    std::printf("zone %u: %s\n", static_cast<unsigned>(response.zone), statusName(response.status));
+    if (response.status != static_cast<std::uint8_t>(hvac::ControlStatus::Ok)) {
+        return;
+    }
+    std::printf("  temperature %.2f °C, humidity %.2f %%, pressure %.1f Pa\n", response.temperature / 100.0,
+                response.humidity / 100.0, response.pressure / 10.0);
+    std::printf("  setpoint %.2f °C / %.2f %%, AC %s, louver %d° / %d°\n", response.setpointTemperature / 100.0,
+                response.setpointHumidity / 100.0, response.acOn ? "on" : "off", response.louverPan,
+                response.louverTilt);
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: hvac_ctl <socket|port> read|setpoint|ac|louver|poll <zone> [values]\n"
+                         "       ac <zone> on|off|toggle, setpoint <zone> <°C> <%%>, louver <zone> <pan> <tilt>,\n"
+                         "       poll <zone> <requests>\n");
+    return 2;
+}
+
+// Разбор аргументов тем же кодом, что и ввод в окне: без локали, без частичного разбора
+bool parseArgument(const char *text, double &value) {
+    return hvac::parseNumber(text, text + std::strlen(text), value) == hvac::InputError::None;
+}
+
+bool parseArgument(const char *text, long long &value) {
+    return hvac::parseInteger(text, text + std::strlen(text), value) == hvac::InputError::None;
+}
+
+bool parseZone(const char *text, hvac::ZoneStore::ZoneId &zone) {
+    long long value = 0;
+    if (!parseArgument(text, value) ||
+        hvac::validateValue(hvac::InputField::Zone, static_cast<double>(value)) != hvac::InputError::None) {
+        return false;
+    }
+    zone = static_cast<hvac::ZoneStore::ZoneId>(value);
+    return true;
+}
+
+/**
+ * @brief Разобранная команда: всё проверяется до подключения к серверу.
+ */
+struct Command {
+    enum Kind { Read, Setpoint, AC, Louver, Poll } kind = Read;
+    hvac::ZoneStore::ZoneId zone = 0;
+    double temperature = 0;
+    double humidity = 0;
+    hvac::ControlACAction action = hvac::ControlACAction::Toggle;
+    long long pan = 0;
+    long long tilt = 0;
+    long long count = 0;
+};
+
+bool parseCommand(int argc, char *argv[], Command &command) {
+    const char *name = argv[2];
+    if (!parseZone(argv[3], command.zone)) {
+        std::fprintf(stderr, "hvac_ctl: bad zone '%s'\n", argv[3]);
+        return false;
+    }
+    if (std::strcmp(name, "read") == 0 && argc == 4) {
+        command.kind = Command::Read;
+        return true;
+    }
+    if (std::strcmp(name, "setpoint") == 0 && argc == 6) {
+        command.kind = Command::Setpoint;
+        return parseArgument(argv[4], command.temperature) && parseArgument(argv[5], command.humidity) &&
+               hvac::isValidSetpoint(command.temperature, command.humidity);
+    }
+    if (std::strcmp(name, "ac") == 0 && argc == 5) {
+        command.kind = Command::AC;
+        if (std::strcmp(argv[4], "on") == 0) {
+            command.action = hvac::ControlACAction::On;
+        } else if (std::strcmp(argv[4], "off") == 0) {
+            command.action = hvac::ControlACAction::Off;
+        } else if (std::strcmp(argv[4], "toggle") == 0) {
+            command.action = hvac::ControlACAction::Toggle;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if (std::strcmp(name, "louver") == 0 && argc == 6) {
+        command.kind = Command::Louver;
+        return parseArgument(argv[4], command.pan) && parseArgument(argv[5], command.tilt) &&
+               hvac::validateValue(hvac::InputField::LouverPan, static_cast<double>(command.pan)) ==
+                   hvac::InputError::None &&
+               hvac::validateValue(hvac::InputField::LouverTilt, static_cast<double>(command.tilt)) ==
+                   hvac::InputError::None;
+    }
+    if (std::strcmp(name, "poll") == 0 && argc == 5) {
+        command.kind = Command::Poll;
+        return parseArgument(argv[4], command.count) && command.count > 0;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Command command;
+    if (argc < 4 || !parseCommand(argc, argv, command)) {
+        return usage();
+    }
+    hvac::ControlClient client;
+    char *end = nullptr;
+    const unsigned long port = std::strtoul(argv[1], &end, 10);
+    const bool connected = (*end == '\0' && port > 0 && port < 65536)
+                               ? client.connectTcp(static_cast<std::uint16_t>(port))
+                               : client.connectUnix(argv[1]);
+    if (!connected) {
+        std::fprintf(stderr, "hvac_ctl: cannot connect to %s\n", argv[1]);
+        return 1;
+    }
+
+    hvac::ControlResponse response;
+    bool ok = false;
+    switch (command.kind) {
+    case Command::Read:
+        ok = client.readState(command.zone, response);
+        break;
+    case Command::Setpoint:
+        ok = client.setSetpoint(command.zone, command.temperature, command.humidity, response);
+        break;
+    case Command::AC:
+        ok = client.setAC(command.zone, command.action, response);
+        break;
+    case Command::Louver:
+        ok = client.setLouver(command.zone, static_cast<int>(command.pan), static_cast<int>(command.tilt), response);
+        break;
+    case Command::Poll: {
+        // Запросы по одному, с ожиданием каждого ответа, как у опрашивающей BMS
+        const auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < command.count; ++i) {
+            ok = client.readState(command.zone, response);
+            if (!ok) {
+                break;
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (ok) {
+            std::printf("%lld requests in %.3f s: %.0f req/s\n", command.count, seconds, command.count / seconds);
+        }
+        break;
+    }
+    }
+
+    if (!ok) {
+        std::fprintf(stderr, "hvac_ctl: connection lost\n");
+        return 1;
+    }
+    printResponse(response);
+    return response.status == static_cast<std::uint8_t>(hvac::ControlStatus::Ok) ? 0 : 1;
+}
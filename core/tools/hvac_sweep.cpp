@@ -0,0 +1,235 @@
+// Пакетный расчёт вариантов настроек на профилях нагрузки площадки по всем ядрам.
+//
+//   hvac_sweep [--threads=N] [--temperature=мин:макс:шаг] [--humidity=мин:макс:шаг]
+//              [--policies=on,occupied,off] [--pan=мин:макс:шаг] [--tilt=мин:макс:шаг]
+//              [--profile=файл.csv ...] [--step=с] [--days=N] [--csv=итоги.csv]
+//              [--top=N] [--comfort-limit=°C]
+//
+// Без --profile считаются две синтетические недели: январская и июльская.
+// В --csv пишутся итоги всех вариантов; на экран — top вариантов с наименьшей
+// энергией среди тех, у кого среднее отклонение от полосы комфорта в занятые
+// часы не больше --comfort-limit.
+
+#include "parametersweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *policyName(hvac::ACPolicy policy) {
+    switch (policy) {
+    case hvac::ACPolicy::AlwaysOn:
+        return "on";
+    case hvac::ACPolicy::Occupied:
+        return "occupied";
+    case hvac::ACPolicy::Off:
+        return "off";
+    }
+    return "?";
+}
+
+// "мин:макс:шаг" или одно значение
+template <typename T>
+bool parseRange(const char *text, std::vector<T> &values) {
+    char *end = nullptr;
+    const double low = std::strtod(text, &end);
+    if (end == text) {
+        return false;
+    }
+    double high = low;
+    double step = 1.0;
+    if (*end == ':') {
+        const char *cursor = end + 1;
+        high = std::strtod(cursor, &end);
+        if (end == cursor || *end != ':') {
+            return false;
+        }
+        cursor = end + 1;
+        step = std::strtod(cursor, &end);
+        if (end == cursor || !(step > 0) || high < low) {
+            return false;
+        }
+    }
+    if (*end != '\0') {
+        return false;
+    }
+    values.clear();
+    // Половина шага допуска, чтобы 18:26:0.5 включало 26
+    for (double value = low; value <= high + step * 0.5 && values.size() < 100000; value += step) {
+        values.push_back(static_cast<T>(std::min(value, high)));
+    }
+    return true;
+}
+
+bool parsePolicies(const char *text, std::vector<hvac::ACPolicy> &policies) {
+    policies.clear();
+    std::string list(text);
+    std::size_t start = 0;
+    while (start <= list.size()) {
+        const std::size_t comma = std::min(list.find(',', start), list.size());
+        const std::string name = list.substr(start, comma - start);
+        if (name == "on") {
+            policies.push_back(hvac::ACPolicy::AlwaysOn);
+        } else if (name == "occupied") {
+            policies.push_back(hvac::ACPolicy::Occupied);
+        } else if (name == "off") {
+            policies.push_back(hvac::ACPolicy::Off);
+        } else {
+            return false;
+        }
+        start = comma + 1;
+    }
+    return !policies.empty();
+}
+
+bool writeCsv(const char *path, const hvac::SweepGrid &grid, const hvac::SweepReport &report) {
+    std::FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "index,temperature,humidity,policy,pan,tilt,energy_kwh,discomfort_degree_hours,"
+                       "hours_outside_band,humidity_hours_outside_band,occupied_hours\n");
+    for (std::size_t i = 0; i < report.configurationCount; ++i) {
+        const hvac::SweepConfiguration configuration = grid.configuration(i);
+        const hvac::SweepMetrics &metrics = report.total[i];
+        std::fprintf(file, "%zu,%.2f,%.1f,%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%.1f\n", i, configuration.temperatureSetpoint,
+                     configuration.humiditySetpoint, policyName(configuration.policy), configuration.louverPan,
+                     configuration.louverTilt, metrics.energyKWh, metrics.discomfortDegreeHours,
+                     metrics.hoursOutsideBand, metrics.humidityHoursOutsideBand, metrics.occupiedHours);
+    }
+    return std::fclose(file) == 0;
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: hvac_sweep [--threads=N] [--temperature=a:b:step] [--humidity=a:b:step]\n"
+                         "                  [--policies=on,occupied,off] [--pan=a:b:step] [--tilt=a:b:step]\n"
+                         "                  [--profile=load.csv ...] [--step=s] [--days=N] [--csv=out.csv]\n"
+                         "                  [--top=N] [--comfort-limit=degC]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    hvac::SweepGrid grid;
+    grid.temperatureSetpoints.clear();
+    grid.louverPans.clear();
+    grid.louverTilts.clear();
+    parseRange("19:25:0.5", grid.temperatureSetpoints);
+    grid.acPolicies = {hvac::ACPolicy::AlwaysOn, hvac::ACPolicy::Occupied};
+    parseRange("0:180:30", grid.louverPans);
+    parseRange("0:90:15", grid.louverTilts);
+
+    unsigned threads = 0;
+    double timeStep = 300.0;
+    double days = 7.0;
+    std::size_t top = 10;
+    double comfortLimit = 0.05;
+    const char *csvPath = nullptr;
+    std::vector<const char *> profilePaths;
+    for (int i = 1; i < argc; ++i) {
+        const char *argument = argv[i];
+        const char *value = std::strchr(argument, '=');
+        value = value != nullptr ? value + 1 : "";
+        bool ok = true;
+        if (std::strncmp(argument, "--threads=", 10) == 0) {
+            threads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        } else if (std::strncmp(argument, "--temperature=", 14) == 0) {
+            ok = parseRange(value, grid.temperatureSetpoints);
+        } else if (std::strncmp(argument, "--humidity=", 11) == 0) {
+            ok = parseRange(value, grid.humiditySetpoints);
+        } else if (std::strncmp(argument, "--policies=", 11) == 0) {
+            ok = parsePolicies(value, grid.acPolicies);
+        } else if (std::strncmp(argument, "--pan=", 6) == 0) {
+            ok = parseRange(value, grid.louverPans);
+        } else if (std::strncmp(argument, "--tilt=", 7) == 0) {
+            ok = parseRange(value, grid.louverTilts);
+        } else if (std::strncmp(argument, "--profile=", 10) == 0) {
+            profilePaths.push_back(value);
+        } else if (std::strncmp(argument, "--step=", 7) == 0) {
+            timeStep = std::atof(value);
+            ok = timeStep > 0;
+        } else if (std::strncmp(argument, "--days=", 7) == 0) {
+            days = std::atof(value);
+            ok = days > 0;
+        } else if (std::strncmp(argument, "--csv=", 6) == 0) {
+            csvPath = value;
+        } else if (std::strncmp(argument, "--top=", 6) == 0) {
+            top = static_cast<std::size_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strncmp(argument, "--comfort-limit=", 16) == 0) {
+            comfortLimit = std::atof(value);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "hvac_sweep: bad argument %s\n", argument);
+            return usage();
+        }
+    }
+
+    std::vector<hvac::LoadProfile> profiles;
+    for (const char *path : profilePaths) {
+        hvac::LoadProfile profile;
+        if (!hvac::loadLoadProfileCsv(path, timeStep, profile)) {
+            std::fprintf(stderr, "hvac_sweep: cannot read load profile %s\n", path);
+            return 1;
+        }
+        profiles.push_back(std::move(profile));
+    }
+    if (profiles.empty()) {
+        const hvac::ClimateProfile climate;
+        profiles.push_back(hvac::syntheticLoadProfile(climate, 14 * 86400.0, days * 86400.0, timeStep));
+        profiles.back().name = "synthetic-january";
+        profiles.push_back(hvac::syntheticLoadProfile(climate, 195 * 86400.0, days * 86400.0, timeStep));
+        profiles.back().name = "synthetic-july";
+    }
+
+    hvac::WorkStealingPool pool(threads);
+    hvac::SweepEvaluator evaluator(pool);
+    hvac::SweepReport report;
+    const auto start = std::chrono::steady_clock::now();
+    if (!evaluator.evaluate(grid, profiles, report)) {
+        std::fprintf(stderr, "hvac_sweep: empty grid or load profile\n");
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%zu configurations x %zu profiles on %u threads: %.2f s (%.0f runs/s, %llu chunks stolen)\n",
+                report.configurationCount, report.profileCount, pool.workerCount(), seconds,
+                static_cast<double>(report.configurationCount * report.profileCount) / seconds,
+                static_cast<unsigned long long>(pool.stolenChunks()));
+
+    if (csvPath != nullptr && !writeCsv(csvPath, grid, report)) {
+        std::fprintf(stderr, "hvac_sweep: cannot write %s\n", csvPath);
+        return 1;
+    }
+
+    // Самые экономные варианты, укладывающиеся в предел комфорта
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < report.configurationCount; ++i) {
+        const hvac::SweepMetrics &metrics = report.total[i];
+        const double meanDeviation =
+            metrics.occupiedHours > 0 ? metrics.discomfortDegreeHours / metrics.occupiedHours : 0.0;
+        if (meanDeviation <= comfortLimit) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return report.total[a].energyKWh < report.total[b].energyKWh;
+    });
+    std::printf("%zu configurations within %.2f °C mean deviation\n", order.size(), comfortLimit);
+    for (std::size_t rank = 0; rank < std::min(top, order.size()); ++rank) {
+        const hvac::SweepConfiguration configuration = grid.configuration(order[rank]);
+        const hvac::SweepMetrics &metrics = report.total[order[rank]];
+        std::printf("  %5.1f °C %4.0f %% %-8s louver %3d°/%2d°: %9.1f kWh, %7.2f °C·h, %6.1f h outside band\n",
+                    configuration.temperatureSetpoint, configuration.humiditySetpoint, policyName(configuration.policy),
+                    configuration.louverPan, configuration.louverTilt, metrics.energyKWh,
+                    metrics.discomfortDegreeHours, metrics.hoursOutsideBand);
+    }
+    return 0;
+}
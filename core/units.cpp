@@ -0,0 +1,137 @@
+#include "units.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HVAC_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace hvac {
+
+const char *unitSymbol(TemperatureUnit unit) {
+    switch (unit) {
+    case TemperatureUnit::Celsius:
+        return "°C";
+    case TemperatureUnit::Fahrenheit:
+        return "°F";
+    case TemperatureUnit::Kelvin:
+        return "K";
+    }
+    return "";
+}
+
+const char *unitSymbol(PressureUnit unit) {
+    switch (unit) {
+    case PressureUnit::Pascal:
+        return "Pa";
+    case PressureUnit::MmHg:
+        return "mmHg";
+    }
+    return "";
+}
+
+namespace {
+
+void convertScalar(const double *in, double *out, std::size_t count, double scale, double offset) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = in[i] * scale + offset;
+    }
+}
+
+// Тождественный пересчёт: одинаковые единицы
+void convertCopy(const double *in, double *out, std::size_t count, double, double) {
+    if (in != out) {
+        std::memmove(out, in, count * sizeof(double));
+    }
+}
+
+#ifdef HVAC_X86_KERNELS
+__attribute__((target("sse2")))
+void convertSse2(const double *in, double *out, std::size_t count, double scale, double offset) {
+    const __m128d scaleVector = _mm_set1_pd(scale);
+    const __m128d offsetVector = _mm_set1_pd(offset);
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d value = _mm_loadu_pd(in + i);
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_mul_pd(value, scaleVector), offsetVector));
+    }
+    convertScalar(in + i, out + i, count - i, scale, offset);
+}
+
+// Без FMA: умножение и сложение округляются так же, как в скалярном ядре
+__attribute__((target("avx2")))
+void convertAvx2(const double *in, double *out, std::size_t count, double scale, double offset) {
+    const __m256d scaleVector = _mm256_set1_pd(scale);
+    const __m256d offsetVector = _mm256_set1_pd(offset);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d low = _mm256_loadu_pd(in + i);
+        __m256d high = _mm256_loadu_pd(in + i + 4);
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(low, scaleVector), offsetVector));
+        _mm256_storeu_pd(out + i + 4, _mm256_add_pd(_mm256_mul_pd(high, scaleVector), offsetVector));
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m256d value = _mm256_loadu_pd(in + i);
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(value, scaleVector), offsetVector));
+    }
+    convertScalar(in + i, out + i, count - i, scale, offset);
+}
+#endif
+
+NamedConversionKernel detectKernel() {
+#ifdef HVAC_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {convertAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {convertSse2, "sse2"};
+    }
+#endif
+    return {convertScalar, "scalar"};
+}
+
+// Процессор проверяется один раз за время работы процесса
+const NamedConversionKernel &kernelChoice() {
+    static const NamedConversionKernel choice = detectKernel();
+    return choice;
+}
+
+} // namespace
+
+ConversionKernel conversionKernel() {
+    return kernelChoice().kernel;
+}
+
+const char *conversionKernelName() {
+    return kernelChoice().name;
+}
+
+std::vector<NamedConversionKernel> availableConversionKernels() {
+    std::vector<NamedConversionKernel> kernels = {{convertScalar, "scalar"}};
+#ifdef HVAC_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back({convertSse2, "sse2"});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({convertAvx2, "avx2"});
+    }
+#endif
+    return kernels;
+}
+
+ConversionPlan::ConversionPlan(AffineConversion conversion)
+    : conversion(conversion),
+      kernel(conversion.scale == 1.0 && conversion.offset == 0.0 ? convertCopy : conversionKernel()) {}
+
+ConversionPlan planConversion(TemperatureUnit from, TemperatureUnit to) {
+    return ConversionPlan(temperatureConversion(from, to));
+}
+
+ConversionPlan planConversion(PressureUnit from, PressureUnit to) {
+    return ConversionPlan(pressureConversion(from, to));
+}
+
+} // namespace hvac
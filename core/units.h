@@ -0,0 +1,148 @@
+#ifndef UNITS_H
+#define UNITS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Единицы измерения температуры.
+ */
+enum class TemperatureUnit {
+    Celsius,
+    Fahrenheit,
+    Kelvin
+};
+
+/**
+ * @brief Единицы измерения давления.
+ */
+enum class PressureUnit {
+    Pascal,
+    MmHg
+};
+
+const char *unitSymbol(TemperatureUnit unit); // Обозначение единицы ("°C", "°F", "K") в UTF-8
+const char *unitSymbol(PressureUnit unit);    // Обозначение единицы ("Pa", "mmHg")
+
+/**
+ * @brief Линейное преобразование y = scale * x + offset.
+ *
+ * Все поддерживаемые пересчёты единиц линейны, поэтому любая пара единиц
+ * сводится к двум коэффициентам, известным на этапе компиляции.
+ */
+struct AffineConversion {
+    double scale;
+    double offset;
+
+    constexpr double apply(double value) const { return value * scale + offset; }
+};
+
+namespace detail {
+constexpr double kKelvinOffset = 273.15;
+constexpr double kPascalsPerMmHg = 133.322;
+
+// Пересчёт в базовые единицы (°C, Pa) и обратно
+constexpr AffineConversion toCelsius(TemperatureUnit unit) {
+    return unit == TemperatureUnit::Fahrenheit ? AffineConversion{5.0 / 9.0, -32.0 * 5.0 / 9.0}
+           : unit == TemperatureUnit::Kelvin   ? AffineConversion{1.0, -kKelvinOffset}
+                                               : AffineConversion{1.0, 0.0};
+}
+
+constexpr AffineConversion fromCelsius(TemperatureUnit unit) {
+    return unit == TemperatureUnit::Fahrenheit ? AffineConversion{9.0 / 5.0, 32.0}
+           : unit == TemperatureUnit::Kelvin   ? AffineConversion{1.0, kKelvinOffset}
+                                               : AffineConversion{1.0, 0.0};
+}
+
+constexpr AffineConversion toPascal(PressureUnit unit) {
+    return unit == PressureUnit::MmHg ? AffineConversion{kPascalsPerMmHg, 0.0} : AffineConversion{1.0, 0.0};
+}
+
+constexpr AffineConversion fromPascal(PressureUnit unit) {
+    return unit == PressureUnit::MmHg ? AffineConversion{1.0 / kPascalsPerMmHg, 0.0} : AffineConversion{1.0, 0.0};
+}
+
+// Композиция: сначала first, затем second
+constexpr AffineConversion compose(AffineConversion first, AffineConversion second) {
+    return {second.scale * first.scale, second.scale * first.offset + second.offset};
+}
+} // namespace detail
+
+constexpr AffineConversion temperatureConversion(TemperatureUnit from, TemperatureUnit to) {
+    return from == to ? AffineConversion{1.0, 0.0}
+                      : detail::compose(detail::toCelsius(from), detail::fromCelsius(to));
+}
+
+constexpr AffineConversion pressureConversion(PressureUnit from, PressureUnit to) {
+    return from == to ? AffineConversion{1.0, 0.0}
+                      : detail::compose(detail::toPascal(from), detail::fromPascal(to));
+}
+
+inline double convertTemperature(double value, TemperatureUnit from, TemperatureUnit to) {
+    return from == to ? value : temperatureConversion(from, to).apply(value);
+}
+
+inline double convertPressure(double value, PressureUnit from, PressureUnit to) {
+    return from == to ? value : pressureConversion(from, to).apply(value);
+}
+
+/**
+ * @brief Пакетное ядро пересчёта: out[i] = scale * in[i] + offset.
+ *
+ * in и out могут совпадать (пересчёт на месте).
+ */
+using ConversionKernel = void (*)(const double *in, double *out, std::size_t count, double scale, double offset);
+
+ConversionKernel conversionKernel(); // Лучшее ядро для текущего процессора (AVX2, SSE2 или скалярное)
+const char *conversionKernelName();  // "avx2", "sse2" или "scalar"
+
+struct NamedConversionKernel {
+    ConversionKernel kernel;
+    const char *name;
+};
+
+// Все ядра, которые может выполнить текущий процессор, первым идёт скалярное (эталон для проверок)
+std::vector<NamedConversionKernel> availableConversionKernels();
+
+/**
+ * @class ConversionPlan
+ * @brief Пересчёт для одной пары единиц, выбранный один раз и применяемый к целым массивам.
+ *
+ * Дашборд создаёт план при смене единиц отображения и затем пересчитывает
+ * из базовых единиц тысячи показаний без сравнения строк и ветвлений на значение.
+ */
+class ConversionPlan {
+public:
+    explicit ConversionPlan(AffineConversion conversion);
+
+    void apply(const double *in, double *out, std::size_t count) const {
+        kernel(in, out, count, conversion.scale, conversion.offset);
+    }
+    double apply(double value) const { return conversion.apply(value); }
+
+private:
+    AffineConversion conversion;
+    ConversionKernel kernel;
+};
+
+ConversionPlan planConversion(TemperatureUnit from, TemperatureUnit to);
+ConversionPlan planConversion(PressureUnit from, PressureUnit to);
+
+// Пересчёт массива с парой единиц, известной на этапе компиляции
+template <TemperatureUnit From, TemperatureUnit To>
+void convertTemperatures(const double *in, double *out, std::size_t count) {
+    constexpr AffineConversion conversion = temperatureConversion(From, To);
+    conversionKernel()(in, out, count, conversion.scale, conversion.offset);
+}
+
+template <PressureUnit From, PressureUnit To>
+void convertPressures(const double *in, double *out, std::size_t count) {
+    constexpr AffineConversion conversion = pressureConversion(From, To);
+    conversionKernel()(in, out, count, conversion.scale, conversion.offset);
+}
+
+} // namespace hvac
+
+#endif // UNITS_H
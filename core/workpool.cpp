@@ -0,0 +1,103 @@
+#include "workpool.h"
+
+#include <algorithm>
+
+namespace hvac {
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers[i]->thread = std::thread(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (const std::unique_ptr<Worker> &worker : workers) {
+        worker->thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, std::size_t grain, const RangeTask &task) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(1, grain);
+    std::lock_guard<std::mutex> call(callMutex);
+
+    // Соседние куски достаются одному потоку: у него и данные рядом в памяти
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+    const std::size_t perWorker = (chunkCount + workers.size() - 1) / workers.size();
+    remaining.store(chunkCount, std::memory_order_relaxed);
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        Worker &worker = *workers[chunk / perWorker];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.chunks.push_back(Chunk{chunk * grain, std::min(count, (chunk + 1) * grain), &task});
+    }
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    ++generation;
+    wake.notify_all();
+    finished.wait(lock, [this]() { return remaining.load(std::memory_order_acquire) == 0; });
+}
+
+bool WorkStealingPool::popLocal(unsigned worker, Chunk &chunk) {
+    Worker &own = *workers[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.chunks.empty()) {
+        return false;
+    }
+    chunk = own.chunks.back();
+    own.chunks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, Chunk &chunk) {
+    const unsigned count = workerCount();
+    for (unsigned offset = 1; offset < count; ++offset) {
+        Worker &victim = *workers[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(unsigned worker) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        Chunk chunk;
+        while (popLocal(worker, chunk) || steal(worker, chunk)) {
+            (*chunk.task)(chunk.begin, chunk.end, worker);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                finished.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace hvac
@@ -0,0 +1,77 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @class WorkStealingPool
+ * @brief Пул потоков для пакетных расчётов: у каждого потока своя очередь, свободные потоки воруют чужую работу.
+ *
+ * parallelFor делит диапазон на куски по grain элементов и раздаёт их по
+ * очередям потоков. Поток берёт свои куски с конца очереди, а закончив — забирает
+ * куски соседей с начала, поэтому неравные по времени куски не оставляют ядра
+ * простаивать. Номер потока передаётся в задачу: по нему задача находит свою
+ * рабочую память и не делит изменяемое состояние с другими потоками.
+ * Задачи не должны бросать исключения.
+ */
+class WorkStealingPool {
+public:
+    // Задача над диапазоном [begin, end); worker — номер потока в [0, workerCount())
+    using RangeTask = std::function<void(std::size_t begin, std::size_t end, unsigned worker)>;
+
+    explicit WorkStealingPool(unsigned threads = 0); // 0 — по числу ядер
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    unsigned workerCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Возвращается, когда обработан весь диапазон; вызовы из разных потоков выполняются по очереди
+    void parallelFor(std::size_t count, std::size_t grain, const RangeTask &task);
+
+    std::uint64_t stolenChunks() const { return stolen.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk {
+        std::size_t begin;
+        std::size_t end;
+        const RangeTask *task; // Задача своего вызова: поток мог проснуться ещё на прошлом
+    };
+
+    // Очереди разных потоков в разных строках кэша
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+        std::thread thread;
+    };
+
+    void run(unsigned worker);
+    bool popLocal(unsigned worker, Chunk &chunk);
+    bool steal(unsigned thief, Chunk &chunk);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex callMutex;   // Один parallelFor за раз
+    std::mutex stateMutex;  // generation, stopping
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+    std::atomic<std::size_t> remaining{0}; // Необработанные куски текущего вызова
+    std::atomic<std::uint64_t> stolen{0};
+};
+
+} // namespace hvac
+
+#endif // WORKPOOL_H
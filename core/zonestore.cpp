@@ -0,0 +1,145 @@
+#include "zonestore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hvac {
+
+ZoneStore::ZoneStore(std::size_t zoneCount) {
+    resize(zoneCount);
+}
+
+void ZoneStore::resize(std::size_t zoneCount) {
+    temperatureValues.resize(zoneCount, 0.0);
+    humidityValues.resize(zoneCount, 0.0);
+    pressureValues.resize(zoneCount, 0.0);
+    setpointTemperatureValues.resize(zoneCount, 0.0);
+    setpointHumidityValues.resize(zoneCount, 0.0);
+    acValues.resize(zoneCount, 0);
+    louverPanValues.resize(zoneCount, 0);
+    louverTiltValues.resize(zoneCount, 0);
+}
+
+void ZoneStore::setReading(ZoneId zone, double temperature, double humidity, double pressure) {
+    temperatureValues[zone] = temperature;
+    humidityValues[zone] = humidity;
+    pressureValues[zone] = pressure;
+}
+
+void ZoneStore::setSetpoint(ZoneId zone, double temperature, double humidity) {
+    setpointTemperatureValues[zone] = temperature;
+    setpointHumidityValues[zone] = humidity;
+}
+
+void ZoneStore::setACStatus(ZoneId zone, bool on) {
+    acValues[zone] = on ? 1 : 0;
+}
+
+void ZoneStore::setLouver(ZoneId zone, std::int16_t pan, std::int16_t tilt) {
+    louverPanValues[zone] = pan;
+    louverTiltValues[zone] = tilt;
+}
+
+ZoneSnapshot ZoneStore::snapshot(ZoneId zone) const {
+    ZoneSnapshot result;
+    result.temperature = temperatureValues[zone];
+    result.humidity = humidityValues[zone];
+    result.pressure = pressureValues[zone];
+    result.setpointTemperature = setpointTemperatureValues[zone];
+    result.setpointHumidity = setpointHumidityValues[zone];
+    result.acOn = acValues[zone] != 0;
+    result.louverPan = louverPanValues[zone];
+    result.louverTilt = louverTiltValues[zone];
+    return result;
+}
+
+void ZoneStore::updateReadingsRange(ZoneId first, std::size_t count, const double *temperature,
+                                    const double *humidity, const double *pressure) {
+    std::copy_n(temperature, count, temperatureValues.begin() + first);
+    std::copy_n(humidity, count, humidityValues.begin() + first);
+    std::copy_n(pressure, count, pressureValues.begin() + first);
+}
+
+void ZoneStore::updateReadings(const ZoneId *ids, std::size_t count, const double *temperature,
+                               const double *humidity, const double *pressure) {
+    // Отдельный проход на каждый столбец: запись идёт в один буфер за раз
+    for (std::size_t i = 0; i < count; ++i) {
+        temperatureValues[ids[i]] = temperature[i];
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        humidityValues[ids[i]] = humidity[i];
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        pressureValues[ids[i]] = pressure[i];
+    }
+}
+
+void ZoneStore::setSetpoints(const ZoneId *ids, std::size_t count, const double *temperature,
+                             const double *humidity) {
+    for (std::size_t i = 0; i < count; ++i) {
+        setpointTemperatureValues[ids[i]] = temperature[i];
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        setpointHumidityValues[ids[i]] = humidity[i];
+    }
+}
+
+void ZoneStore::setACStatus(const ZoneId *ids, std::size_t count, bool on) {
+    const std::uint8_t value = on ? 1 : 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        acValues[ids[i]] = value;
+    }
+}
+
+void ZoneStore::setLouvers(const ZoneId *ids, std::size_t count, const std::int16_t *pan,
+                           const std::int16_t *tilt) {
+    for (std::size_t i = 0; i < count; ++i) {
+        louverPanValues[ids[i]] = pan[i];
+        louverTiltValues[ids[i]] = tilt[i];
+    }
+}
+
+void ZoneStore::gather(const ZoneId *ids, std::size_t count, ZoneSnapshot *out) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = snapshot(ids[i]);
+    }
+}
+
+std::size_t ZoneStore::findDeviating(double tolerance, ZoneId *out) const {
+    const std::size_t zoneCount = size();
+    const double *temperatures = temperatureValues.data();
+    const double *setpoints = setpointTemperatureValues.data();
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < zoneCount; ++i) {
+        // Запись без ветвления: индекс пишется всегда, счётчик растёт только при отклонении
+        out[found] = static_cast<ZoneId>(i);
+        found += std::fabs(temperatures[i] - setpoints[i]) > tolerance ? 1 : 0;
+    }
+    return found;
+}
+
+std::size_t ZoneStore::countACOn() const {
+    std::size_t count = 0;
+    for (std::uint8_t value : acValues) {
+        count += value;
+    }
+    return count;
+}
+
+void SetpointBatch::clear() {
+    zones.clear();
+    temperature.clear();
+    humidity.clear();
+}
+
+void SetpointBatch::reserve(std::size_t count) {
+    zones.reserve(count);
+    temperature.reserve(count);
+    humidity.reserve(count);
+}
+
+void SetpointBatch::applyTo(ZoneStore &store) const {
+    store.setSetpoints(zones.data(), zones.size(), temperature.data(), humidity.data());
+}
+
+} // namespace hvac
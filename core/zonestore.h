@@ -0,0 +1,115 @@
+#ifndef ZONESTORE_H
+#define ZONESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hvac {
+
+/**
+ * @brief Копия состояния одной зоны (для отображения выбранной зоны в окне).
+ */
+struct ZoneSnapshot {
+    double temperature = 0;         // Температура, °C
+    double humidity = 0;            // Влажность, %
+    double pressure = 0;            // Давление, Pa
+    double setpointTemperature = 0; // Уставка температуры, °C
+    double setpointHumidity = 0;    // Уставка влажности, %
+    bool acOn = false;              // Статус кондиционера
+    std::int16_t louverPan = 0;     // Горизонтальный угол жалюзи, градусы
+    std::int16_t louverTilt = 0;    // Вертикальный угол жалюзи, градусы
+};
+
+/**
+ * @class ZoneStore
+ * @brief Хранилище множества зон в виде структуры массивов (SoA).
+ *
+ * Каждое поле зоны лежит в отдельном непрерывном буфере, поэтому пакетные
+ * операции проходят по памяти линейно и не требуют QObject на зону.
+ * Значения хранятся в базовых единицах (°C, %, Pa) независимо от единиц отображения.
+ */
+class ZoneStore {
+public:
+    using ZoneId = std::uint32_t;
+
+    explicit ZoneStore(std::size_t zoneCount = 1);
+
+    std::size_t size() const { return temperatureValues.size(); }
+    void resize(std::size_t zoneCount); // Новые зоны заполняются нулями
+
+    // Операции над одной зоной
+    void setReading(ZoneId zone, double temperature, double humidity, double pressure);
+    void setSetpoint(ZoneId zone, double temperature, double humidity);
+    void setACStatus(ZoneId zone, bool on);
+    void setLouver(ZoneId zone, std::int16_t pan, std::int16_t tilt);
+    ZoneSnapshot snapshot(ZoneId zone) const;
+
+    double temperature(ZoneId zone) const { return temperatureValues[zone]; }
+    double humidity(ZoneId zone) const { return humidityValues[zone]; }
+    double pressure(ZoneId zone) const { return pressureValues[zone]; }
+    bool acStatus(ZoneId zone) const { return acValues[zone] != 0; }
+
+    // Пакетное обновление непрерывного диапазона зон [first, first + count)
+    void updateReadingsRange(ZoneId first, std::size_t count, const double *temperature,
+                             const double *humidity, const double *pressure);
+    // Пакетное обновление произвольного набора зон (ids[i] получает значения i)
+    void updateReadings(const ZoneId *ids, std::size_t count, const double *temperature,
+                        const double *humidity, const double *pressure);
+    void setSetpoints(const ZoneId *ids, std::size_t count, const double *temperature,
+                      const double *humidity);
+    void setACStatus(const ZoneId *ids, std::size_t count, bool on);
+    void setLouvers(const ZoneId *ids, std::size_t count, const std::int16_t *pan,
+                    const std::int16_t *tilt);
+
+    // Пакетные запросы
+    void gather(const ZoneId *ids, std::size_t count, ZoneSnapshot *out) const;
+    // Зоны, где |температура - уставка| > tolerance; out должен вмещать size() элементов
+    std::size_t findDeviating(double tolerance, ZoneId *out) const;
+    std::size_t countACOn() const;
+
+    // Прямой доступ к столбцам только для чтения
+    const double *temperatures() const { return temperatureValues.data(); }
+    const double *humidities() const { return humidityValues.data(); }
+    const double *pressures() const { return pressureValues.data(); }
+    const double *setpointTemperatures() const { return setpointTemperatureValues.data(); }
+    const double *setpointHumidities() const { return setpointHumidityValues.data(); }
+    const std::uint8_t *acStatuses() const { return acValues.data(); }
+    const std::int16_t *louverPans() const { return louverPanValues.data(); }
+    const std::int16_t *louverTilts() const { return louverTiltValues.data(); }
+
+    // Запись показаний на месте (для моделирования)
+    double *temperatures() { return temperatureValues.data(); }
+    double *humidities() { return humidityValues.data(); }
+
+private:
+    std::vector<double> temperatureValues;         // Температура, °C
+    std::vector<double> humidityValues;            // Влажность, %
+    std::vector<double> pressureValues;            // Давление, Pa
+    std::vector<double> setpointTemperatureValues; // Уставки температуры, °C
+    std::vector<double> setpointHumidityValues;    // Уставки влажности, %
+    std::vector<std::uint8_t> acValues;            // Статусы кондиционеров (0/1)
+    std::vector<std::int16_t> louverPanValues;     // Горизонтальные углы жалюзи
+    std::vector<std::int16_t> louverTiltValues;    // Вертикальные углы жалюзи
+};
+
+/**
+ * @brief Пакет уставок по зонам (расписание, импорт таблиц уставок).
+ *
+ * Столбцы совпадают с аргументами ZoneStore::setSetpoints, поэтому пакет
+ * применяется к хранилищу одним вызовом.
+ */
+struct SetpointBatch {
+    std::vector<ZoneStore::ZoneId> zones;
+    std::vector<double> temperature;
+    std::vector<double> humidity;
+
+    std::size_t size() const { return zones.size(); }
+    void clear();
+    void reserve(std::size_t count);
+    void applyTo(ZoneStore &store) const;
+};
+
+} // namespace hvac
+
+#endif // ZONESTORE_H
@@ -0,0 +1,42 @@
+#include "labelrenderer.h"
+
+#include <QLabel>
+#include <QTimer>
+
+LabelRenderer::LabelRenderer(QLabel *temperatureLabel, QLabel *humidityLabel, QLabel *pressureLabel,
+                             QObject *parent)
+    : QObject(parent),
+      labels{temperatureLabel, humidityLabel, pressureLabel} {
+    formatter.setPrefix(hvac::ReadoutFormatter::Temperature, "Температура: ");
+    formatter.setPrefix(hvac::ReadoutFormatter::Humidity, "Влажность: ");
+    formatter.setPrefix(hvac::ReadoutFormatter::Pressure, "Давление: ");
+
+    frameTimer = new QTimer(this);
+    frameTimer->setSingleShot(true);
+    frameTimer->setInterval(kFrameIntervalMs);
+    connect(frameTimer, &QTimer::timeout, this, &LabelRenderer::flush);
+}
+
+void LabelRenderer::setReadings(double temperature, hvac::TemperatureUnit temperatureUnit, int humidity,
+                                double pressure, hvac::PressureUnit pressureUnit) {
+    formatter.setTemperature(temperature, temperatureUnit);
+    formatter.setHumidity(humidity);
+    formatter.setPressure(pressure, pressureUnit);
+
+    // Несколько обновлений за кадр сворачиваются в одну перерисовку
+    if (formatter.anyDirty() && !frameTimer->isActive()) {
+        frameTimer->start();
+    }
+}
+
+void LabelRenderer::flush() {
+    frameTimer->stop();
+    for (int field = 0; field < hvac::ReadoutFormatter::FieldCount; ++field) {
+        const auto id = static_cast<hvac::ReadoutFormatter::Field>(field);
+        if (!formatter.isDirty(id)) {
+            continue;
+        }
+        const std::string_view text = formatter.take(id);
+        labels[field]->setText(QString::fromUtf8(text.data(), static_cast<int>(text.size())));
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef LABELRENDERER_H
+#define LABELRENDERER_H
+
+#include <QObject>
+
+#include "readoutformatter.h"
+
+class QLabel;
+class QTimer;
+
+/**
+ * @class LabelRenderer
+ * @brief Перерисовка меток показаний не чаще одного раза за кадр и только изменившихся.
+ *
+ * Новые значения лишь помечают поля изменёнными; при срабатывании таймера кадра
+ * форматируются и получают setText только поля, чей видимый текст изменился.
+ */
+class LabelRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    LabelRenderer(QLabel *temperatureLabel, QLabel *humidityLabel, QLabel *pressureLabel,
+                  QObject *parent = nullptr);
+
+    void setReadings(double temperature, hvac::TemperatureUnit temperatureUnit, int humidity,
+                     double pressure, hvac::PressureUnit pressureUnit);
+    void flush(); // Немедленная отрисовка (например, при первом показе окна)
+
+private:
+    static constexpr int kFrameIntervalMs = 16; // ~60 кадров в секунду
+
+    hvac::ReadoutFormatter formatter;                    // Тексты и флаги изменений
+    QLabel *labels[hvac::ReadoutFormatter::FieldCount];  // Метки по полям
+    QTimer *frameTimer;                                  // Однократный таймер кадра
+};
+
+#endif // LABELRENDERER_H
@@ -9,8 +9,33 @@
 #include <QLineEdit>
 #include <QDialog>
 #include <QMessageBox>
-#include <QDebug>
 #include <QSlider>
+#include <QSpinBox>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QPaintEvent>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "actuator.h"
+#include "controlserver.h"
+#include "hvaccontroller.h"
+#include "inputvalidation.h"
+#include "instrumentation.h"
+#include "labelrenderer.h"
+#include "scheduleengine.h"
+#include "sensoringestion.h"
+#include "sessionprofile.h"
+#include "telemetry.h"
+#include "thermalsim.h"
+#include "trendchart.h"
 
 /**
  * @class ResolutionDialog
@@ -80,6 +105,19 @@ public:
         layout->addWidget(new QLabel("Установить Давление:"));
         layout->addWidget(pressureInput);
 
+        // Пока показания задают модель или датчики, поясняем, что из ввода применяется
+        liveNoteLabel = new QLabel("Показания задают модель помещения или датчики: температура и влажность "
+                                   "применяются как уставки зоны, давление не вводится.", this);
+        liveNoteLabel->setWordWrap(true);
+        liveNoteLabel->hide();
+        layout->addWidget(liveNoteLabel);
+
+        // Ошибка ввода показывается под полями и не блокирует окно
+        errorLabel = new QLabel(this);
+        errorLabel->setStyleSheet("color: #c0392b;");
+        errorLabel->setWordWrap(true);
+        layout->addWidget(errorLabel);
+
         QPushButton *updateButton = new QPushButton("Обновить значения", this);
         connect(updateButton, &QPushButton::clicked, this, &SettingsDialog::updateValues);
         layout->addWidget(updateButton);
@@ -88,36 +126,120 @@ public:
     }
 
     void updateValues() {
-        bool tempOk, humidityOk, pressureOk;
-        float tempValue = temperatureInput->text().toFloat(&tempOk);
-        int humidityValue = humidityInput->text().toInt(&humidityOk);
-        float pressureValue = pressureInput->text().toFloat(&pressureOk);
-
-        if (!tempOk || tempValue < -50 || tempValue > 70) {
-            QMessageBox::warning(this, "Неверный ввод", "Пожалуйста, введите допустимую температуру.");
+        // Разбор не зависит от локали: в поле всегда ожидается точка
+        const QByteArray temperatureText = temperatureInput->text().toUtf8();
+        const QByteArray humidityText = humidityInput->text().toUtf8();
+        const QByteArray pressureText = pressureInput->text().toUtf8();
+        double tempValue = 0;
+        long long humidityValue = 0;
+        double pressureValue = 0;
+
+        // Температура вводится в единицах отображения, а пределы заданы в °C
+        hvac::InputError error = hvac::parseNumber(temperatureText.constBegin(), temperatureText.constEnd(), tempValue);
+        if (error == hvac::InputError::None) {
+            const double celsius = hvac::convertTemperature(tempValue, temperatureUnit, hvac::TemperatureUnit::Celsius);
+            error = hvac::validateValue(hvac::InputField::Temperature, celsius);
+        }
+        if (error != hvac::InputError::None) {
+            QString fieldName = "Температура";
+            if (error == hvac::InputError::OutOfRange) {
+                // Пределы показываем в тех же единицах, что и поле
+                const hvac::ValueRange range = hvac::rangeOf(hvac::InputField::Temperature);
+                fieldName += QString(" (%1…%2 %3)")
+                                 .arg(hvac::convertTemperature(range.minimum, hvac::TemperatureUnit::Celsius,
+                                                               temperatureUnit), 0, 'g', 6)
+                                 .arg(hvac::convertTemperature(range.maximum, hvac::TemperatureUnit::Celsius,
+                                                               temperatureUnit), 0, 'g', 6)
+                                 .arg(QString::fromUtf8(hvac::unitSymbol(temperatureUnit)));
+            }
+            showError(temperatureInput, fieldName, error);
             return;
         }
-        if (!humidityOk || humidityValue < 0 || humidityValue > 100) {
-            QMessageBox::warning(this, "Неверный ввод", "Пожалуйста, введите допустимый процент влажности.");
+        error = hvac::parseInteger(humidityText.constBegin(), humidityText.constEnd(), humidityValue);
+        if (error == hvac::InputError::None) {
+            error = hvac::validateValue(hvac::InputField::Humidity, static_cast<double>(humidityValue));
+        }
+        if (error != hvac::InputError::None) {
+            showError(humidityInput, "Влажность", error);
             return;
         }
-        if (!pressureOk || pressureValue < 0) {
-            QMessageBox::warning(this, "Неверный ввод", "Пожалуйста, введите допустимое давление.");
+        if (pressureInput->isEnabled()) {
+            error = hvac::parseField(hvac::InputField::Pressure, pressureText.constBegin(), pressureText.constEnd(),
+                                     pressureValue);
+        }
+        if (error != hvac::InputError::None) {
+            showError(pressureInput, "Давление", error);
             return;
         }
 
-        emit valuesUpdated(tempValue, humidityValue, pressureValue);
+        errorLabel->clear();
+        emit valuesUpdated(static_cast<float>(tempValue), static_cast<int>(humidityValue),
+                           static_cast<float>(pressureValue));
+    }
+
+    // Единица, в которой пользователь вводит температуру (как на шкале окна)
+    void setTemperatureUnit(hvac::TemperatureUnit unit) { temperatureUnit = unit; }
+
+    // Показания идут от модели или датчиков: введённое давление применить некуда, поле отключается
+    void setLiveReadings(bool live) {
+        pressureInput->setEnabled(!live);
+        liveNoteLabel->setVisible(live);
     }
 
 signals:
     void valuesUpdated(float temp, int humidity, float pressure);
 
 private:
+    void showError(QLineEdit *input, const QString &fieldName, hvac::InputError error) {
+        errorLabel->setText(QString("%1: %2").arg(fieldName, QString::fromUtf8(hvac::inputErrorMessage(error))));
+        input->setFocus();
+        input->selectAll();
+    }
+
     QLineEdit *temperatureInput; // Поле ввода температуры
     QLineEdit *humidityInput;    // Поле ввода влажности
     QLineEdit *pressureInput;    // Поле ввода давления
+    QLabel *errorLabel;          // Причина отказа последнего ввода
+    QLabel *liveNoteLabel;       // Пояснение, пока показания не берутся из ввода
+    hvac::TemperatureUnit temperatureUnit = hvac::TemperatureUnit::Celsius; // Единица поля температуры
 };
 
+/**
+ * @brief Таблица стилей окна для темы, собранная один раз за процесс.
+ *
+ * Правила слайдеров входят в таблицу окна, поэтому Qt разбирает стили
+ * один раз для всего окна, а не отдельно для каждого слайдера.
+ */
+static const QString &themeStyleSheet(hvac::Theme theme) {
+    static const QString sliderRules = "QSlider::groove:horizontal {"
+                                       "background: lightgray;"
+                                       "height: 50px;"
+                                       "}"
+                                       "QSlider::handle:horizontal {"
+                                       "background: green;"
+                                       "border: 1px solid #5c5c5c;"
+                                       "width: 50px;"  // Ширина бегунка
+                                       "height: 50px;" // Высота бегунка
+                                       "}"
+                                       "QSlider::groove:vertical {"
+                                       "background: lightgray;" // Цвет фона грива
+                                       "width: 50px;"          // Устанавливаем ширину грива
+                                       "}"
+                                       "QSlider::handle:vertical {"
+                                       "background: green;"    // Цвет бегунка
+                                       "border: 1px solid #5c5c5c;" // Граница бегунка
+                                       "width: 50px;"         // Ширина бегунка
+                                       "height: 50px;"        // Высота бегунка
+                                       "}";
+    static const QString light = "QWidget { background-color: #ffffff; color: black; }" + sliderRules;
+    static const QString dark = "QWidget { background-color: #2e2e2e; color: white; }" + sliderRules;
+    return theme == hvac::Theme::Light ? light : dark;
+}
+
+static hvac::Theme themeFromName(const QString &name) {
+    return name == "Light" ? hvac::Theme::Light : hvac::Theme::Dark;
+}
+
 /**
  * @class HVACControl
  * @brief Главный класс управления HVAC.
@@ -126,74 +248,148 @@ class HVACControl : public QMainWindow {
     Q_OBJECT
 
 public:
-    HVACControl(int width, int height, QString theme, QWidget *parent = nullptr);
+    HVACControl(int width, int height, hvac::Theme theme, QWidget *parent = nullptr);
+
+    hvac::SensorIngestion &sensorIngestion() { return ingestion; } // Вход для потоков датчиков
+    void setRefreshRate(int hz);                                    // Частота применения показаний к окну
+    void startSensorSimulation(double samplesPerSecond);            // Локальный имитатор датчиков
+    void setSimulationSpeed(double speed);                          // Ускорение модели помещений (0 — выкл.)
+    bool startTelemetry(const QString &path);                       // Запись двоичного журнала
+    bool replayTelemetry(const QString &path);                      // Восстановление состояния из журнала
+    void applyProfile(const hvac::SessionProfile &profile);         // Единицы, уставки и зона прошлого сеанса
+    bool startControlServer(const QString &address);                // Протокол управления: путь к сокету или порт
+    bool useSchedule(const QString &name);                          // Встроенная недельная программа для всех зон
+    bool importSetpoints(const QString &path);                      // Таблица уставок CSV или HVST
+    hvac::SessionProfile sessionProfile() const;                    // Текущее состояние для следующего запуска
+
+public slots:
+    void showSettings(); // Диалог настроек создаётся при первом открытии
+
+signals:
+    void firstFramePainted(); // Окно впервые нарисовано (для замера времени запуска)
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
 
 private slots:
     void toggleAC();
-    void changeScaleTemperature(const QString &scale);
-    void changeScalePressure(const QString &scale);
+    void changeScaleTemperature(int index);
+    void changeScalePressure(int index);
     void updateFromSettings(float temp, int humidity, float pressure);
-    void changeAirDirection(int angle); // Изменение направления воздуха
+    void changeAirDirectionPan(int angle);  // Изменение горизонтального направления воздуха
+    void changeAirDirectionTilt(int angle); // Изменение вертикального направления воздуха
+    void selectZone(int zone);          // Выбор отображаемой зоны
+    void applySensorBatch();            // Применение накопленных показаний датчиков
+    void sampleTrend();                 // Запись показаний выбранной зоны в график
+    void advanceSimulation();           // Шаг модели помещений по реальному времени
+    void applyControlCommands();        // Изменения от клиентов протокола управления
+    void applySchedule();               // Уставки недельной программы, наступившие за период
+    void buildDeferredWidgets();        // Второстепенные виджеты после первого кадра
 
 private:
-    QString unittemperature = "°C"; // Единицы измерения температуры
-    double temp = 0;                // Температура
+    static constexpr int kZoneCount = 16;       // Число зон, доступных для выбора в окне
+    static constexpr int kDefaultRefreshHz = 20; // Частота обновления окна по умолчанию
+    static constexpr int kTrendSampleHz = 10;    // Частота записи точек графика
+    static constexpr std::size_t kTrendHistorySize = 6 * 3600 * kTrendSampleHz; // 6 часов истории
+    static constexpr double kSimulationStepSeconds = 10.0; // Шаг модели помещений
+    static constexpr double kDefaultSimulationSpeed = 60.0; // Секунда на экране — минута модели
+    static constexpr double kLouverCommandsPerSecond = 5.0;  // Предел команд приводу жалюзи на зону
+    static constexpr int kScheduleCheckMs = 1000;            // Точность переключений расписания
+
+    static hvac::ScheduleTime currentScheduleTime(); // Местное время в шкале расписания
+    bool liveReadings() const { return simulationSpeed > 0 || sensorSimulator; } // Показания не из диалога
+    void overrideSchedule(hvac::ZoneStore::ZoneId zone); // Ручная уставка действует до переключения программы
+
+    hvac::ZoneStore zones{kZoneCount};  // Состояние всех зон (без виджетов)
+    hvac::Controller controller{zones}; // Окно показывает одну выбранную зону
+    hvac::SensorIngestion ingestion{kZoneCount};              // Очередь показаний от датчиков
+    hvac::SensorBatch sensorBatch;                            // Свёрнутые показания за период
+    std::unique_ptr<hvac::SensorSimulator> sensorSimulator;   // Имитатор датчиков (если запущен)
+    QTimer *refreshTimer;           // Таймер применения показаний датчиков
+    hvac::SimulationEngine simulation{zones, kSimulationStepSeconds}; // Модель помещений и ПИД-регуляторы
+    double simulationSpeed = kDefaultSimulationSpeed; // Ускорение модели (0 — модель выключена)
+    QElapsedTimer simulationClock;  // Реальное время между шагами модели
+    std::unique_ptr<hvac::TelemetryWriter> telemetry; // Журнал телеметрии (если включён)
+    std::unique_ptr<hvac::ControlServer> controlServer; // Сервер протокола управления (если включён)
+    std::vector<hvac::ControlCommand> controlCommands;  // Изменения, забранные у сервера за период
+    hvac::ScheduleEngine schedule{kZoneCount, currentScheduleTime()}; // Недельные программы уставок
+    hvac::SetpointBatch scheduledSetpoints; // Уставки расписания за период
+    QTimer *scheduleTimer;          // Таймер проверки расписания
+    QSpinBox *zoneSpinBox;          // Выбор зоны
     QLabel *temperatureLabel;       // Метка для температуры
-    int humidity = 0;               // Влажность
     QLabel *humidityLabel;          // Метка для влажности
-    QString unitpressure = "Pa";    // Единицы измерения давления
-    double pressure = 0;            // Давление
     QLabel *pressureLabel;          // Метка для давления
+    LabelRenderer *labelRenderer;   // Перерисовка меток показаний по кадрам
     QComboBox *tempScaleCombo;      // Комбинированный список для масштабирования температуры
     QComboBox *pressureScaleCombo;  // Комбинированный список для масштабирования давления
     QPushButton *toggleButton;      // Кнопка для включения/выключения кондиционера
-    bool acStatus;                  // Статус кондиционера
-    QGraphicsView *graphicsView;    // Виджет для рисования графики
-    QGraphicsScene *scene;          // Сцена для графики
-    SettingsDialog *settingsDialog; // Диалог настроек
+    QVBoxLayout *mainLayout;        // Основной layout окна
+    QGraphicsView *graphicsView = nullptr; // Виджет для рисования графики (после первого кадра)
+    QGraphicsScene *scene = nullptr;       // Сцена для графики
+    TrendChart *trendChart = nullptr;      // График показаний выбранной зоны
+    QTimer *trendTimer;             // Таймер записи точек графика
+    SettingsDialog *settingsDialog = nullptr; // Диалог настроек (при первом открытии)
+    bool firstFrameDone = false;    // Первый кадр уже нарисован
+    hvac::Theme windowTheme;        // Тема окна (для профиля сеанса)
     QSlider *airDirectionSlider;     // Горизонтальный слайдер направления воздуха
     QSlider *airDirectionSliderVertical; // Вертикальный слайдер направления воздуха
     QLabel *airDirectionLabel;       // Метка для отображения направления
+    std::unique_ptr<hvac::ActuatorChannel> louverChannel; // Команды приводам жалюзи
     QHBoxLayout *directionLayout;    // Новый layout для направления
 
-    void updateLabels(double temp, int humidity, float pressure, const QString &scaleT, const QString &scaleP);
-    void convertTemperature(const QString &toScale);
-    void convertPressure(const QString &toScale);
+    void updateLabels();
+    void updateAirDirection(); // Метка направления и запись в журнал
 };
 
-HVACControl::HVACControl(int width, int height, QString theme, QWidget *parent)
-    : QMainWindow(parent), acStatus(false) {
+HVACControl::HVACControl(int width, int height, hvac::Theme theme, QWidget *parent)
+    : QMainWindow(parent), windowTheme(theme) {
 
     setFixedSize(width, height);
 
-    if (theme == "Light") {
-        setStyleSheet("background-color: #ffffff; color: black;");
-    } else {
-        setStyleSheet("background-color: #2e2e2e; color: white;");
+    // Начальное состояние всех зон: комнатные условия, типичные уставки
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < zones.size(); ++zone) {
+        zones.setReading(zone, 24.0, 50.0, 101325.0);
+        zones.setSetpoint(zone, 22.0, 45.0);
     }
 
+    setStyleSheet(themeStyleSheet(theme));
+
     QWidget *centralWidget = new QWidget(this);
     QVBoxLayout *layout = new QVBoxLayout(centralWidget);
+    mainLayout = layout;
 
     // Инициализируем directionLayout
     directionLayout = new QHBoxLayout();
 
-    temperatureLabel = new QLabel("Температура: " + QString::number(temp) + " " + unittemperature, this);
-    humidityLabel = new QLabel("Влажность: " + QString::number(humidity) + " %", this);
-    pressureLabel = new QLabel("Давление: " + QString::number(pressure) + " " + unitpressure, this);
+    zoneSpinBox = new QSpinBox(this);
+    zoneSpinBox->setRange(0, kZoneCount - 1);
+    zoneSpinBox->setPrefix("Зона ");
+    connect(zoneSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &HVACControl::selectZone);
+    layout->addWidget(zoneSpinBox);
+
+    temperatureLabel = new QLabel(this);
+    humidityLabel = new QLabel(this);
+    pressureLabel = new QLabel(this);
+    labelRenderer = new LabelRenderer(temperatureLabel, humidityLabel, pressureLabel, this);
+    updateLabels();
+    labelRenderer->flush();
 
     layout->addWidget(temperatureLabel);
     layout->addWidget(humidityLabel);
     layout->addWidget(pressureLabel);
 
     tempScaleCombo = new QComboBox(this);
+    // Порядок пунктов совпадает с порядком hvac::TemperatureUnit
     tempScaleCombo->addItems({"Celsius", "Fahrenheit", "Kelvin"});
-    connect(tempScaleCombo, &QComboBox::currentTextChanged, this, &HVACControl::changeScaleTemperature);
+    connect(tempScaleCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HVACControl::changeScaleTemperature);
     layout->addWidget(tempScaleCombo);
 
     pressureScaleCombo = new QComboBox(this);
+    // Порядок пунктов совпадает с порядком hvac::PressureUnit
     pressureScaleCombo->addItems({"Pascals", "mmHg"});
-    connect(pressureScaleCombo, &QComboBox::currentTextChanged, this, &HVACControl::changeScalePressure);
+    connect(pressureScaleCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HVACControl::changeScalePressure);
     layout->addWidget(pressureScaleCombo);
 
     toggleButton = new QPushButton("Включить кондиционер", this);
@@ -203,39 +399,13 @@ HVACControl::HVACControl(int width, int height, QString theme, QWidget *parent)
     airDirectionSlider = new QSlider(Qt::Horizontal, this);
     airDirectionSlider->setRange(0, 180);
     airDirectionSlider->setFixedHeight(50); // Устанавливаем фиксированную высоту на 50 пикселей
-    connect(airDirectionSlider, &QSlider::valueChanged, this, &HVACControl::changeAirDirection);
-    // Горизонтальный слайдер
-    airDirectionSlider->setStyleSheet("QSlider::groove:horizontal {"
-                                      "background: lightgray;"
-                                      "height: 50px;"
-                                      "}"
-                                      "QSlider::handle:horizontal {"
-                                      "background: green;"
-                                      "border: 1px solid #5c5c5c;"
-                                      "width: 50px;"  // Ширина бегунка
-                                      "height: 50px;" // Высота бегунка
-                                      "}");
+    connect(airDirectionSlider, &QSlider::valueChanged, this, &HVACControl::changeAirDirectionPan);
 
     // Вертикальный слайдер
     airDirectionSliderVertical = new QSlider(Qt::Vertical, this);
     airDirectionSliderVertical->setRange(0, 90); // Устанавливаем диапазон от 0 до 90
     airDirectionSliderVertical->setFixedWidth(50); // Устанавливаем фиксированную ширину на 50 пикселей
-    connect(airDirectionSliderVertical, &QSlider::valueChanged, this, &HVACControl::changeAirDirection);
-
-    // Установка стилей для слайдера
-    airDirectionSliderVertical->setStyleSheet("QSlider::groove:vertical {"
-                                              "background: lightgray;" // Цвет фона грива
-                                              "width: 50px;"          // Устанавливаем ширину грива
-                                              "}"
-                                              "QSlider::handle:vertical {"
-                                              "background: green;"    // Цвет бегунка
-                                              "border: 1px solid #5c5c5c;" // Граница бегунка
-                                              "width: 50px;"         // Ширина бегунка
-                                              "height: 50px;"        // Высота бегунка
-                                              "}");
-
-
-
+    connect(airDirectionSliderVertical, &QSlider::valueChanged, this, &HVACControl::changeAirDirectionTilt);
 
     // Добавляем метки и слайдеры в directionLayout
     directionLayout->addWidget(new QLabel("Горизонтальное направление (градусы):", this));
@@ -245,118 +415,514 @@ HVACControl::HVACControl(int width, int height, QString theme, QWidget *parent)
 
     layout->addLayout(directionLayout); // Добавляем directionLayout в главный layout
 
-    airDirectionLabel = new QLabel("Текущее направление: 0°", this);
+    airDirectionLabel = new QLabel("Текущее направление: 0° / 0°", this);
     layout->addWidget(airDirectionLabel);
 
+    // Реальной шины жалюзи пока нет: команды принимает заглушка без хранения истории
+    louverChannel = std::make_unique<hvac::ActuatorChannel>(std::make_unique<hvac::NullActuatorBackend>(),
+                                                            kZoneCount, kLouverCommandsPerSecond);
+
+    QPushButton *settingsButton = new QPushButton("Настройки", this);
+    connect(settingsButton, &QPushButton::clicked, this, &HVACControl::showSettings);
+    layout->addWidget(settingsButton);
+
+    // График строится после первого кадра (buildDeferredWidgets), точки журнала пишутся сразу
+    trendTimer = new QTimer(this);
+    trendTimer->setInterval(1000 / kTrendSampleHz);
+    connect(trendTimer, &QTimer::timeout, this, &HVACControl::sampleTrend);
+    trendTimer->start();
+
+    setCentralWidget(centralWidget);
+
+    // Показания датчиков применяются пакетом не чаще частоты обновления
+    sensorBatch.reserve(kZoneCount);
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &HVACControl::applySensorBatch);
+    connect(refreshTimer, &QTimer::timeout, this, &HVACControl::advanceSimulation);
+    connect(refreshTimer, &QTimer::timeout, this, &HVACControl::applyControlCommands); // Последним: публикует снимок
+    setRefreshRate(kDefaultRefreshHz);
+    refreshTimer->start();
+    simulationClock.start();
+
+    // Переключения расписания приходят пакетом раз в секунду, а не сигналом на каждую зону
+    scheduleTimer = new QTimer(this);
+    scheduleTimer->setInterval(kScheduleCheckMs);
+    connect(scheduleTimer, &QTimer::timeout, this, &HVACControl::applySchedule);
+    scheduleTimer->start();
+}
+
+void HVACControl::paintEvent(QPaintEvent *event) {
+    QMainWindow::paintEvent(event);
+    if (!firstFrameDone) {
+        firstFrameDone = true;
+        emit firstFramePainted();
+        // Пользователь уже видит окно; остальное достраиваем на следующем проходе цикла событий
+        QTimer::singleShot(0, this, &HVACControl::buildDeferredWidgets);
+    }
+}
+
+void HVACControl::buildDeferredWidgets() {
+    if (graphicsView != nullptr) {
+        return;
+    }
     graphicsView = new QGraphicsView(this);
     scene = new QGraphicsScene(this);
     graphicsView->setScene(scene);
-    layout->addWidget(graphicsView);
+    graphicsView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    graphicsView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    mainLayout->addWidget(graphicsView);
 
-    setCentralWidget(centralWidget);
+    trendChart = new TrendChart(graphicsView, scene, kTrendHistorySize, this);
+}
 
-    // Создаем и показываем диалоговое окно настроек
-    settingsDialog = new SettingsDialog(this);
+void HVACControl::showSettings() {
+    if (settingsDialog == nullptr) {
+        settingsDialog = new SettingsDialog(this);
+        // Подключаем сигнал для обновления значений из настроек
+        connect(settingsDialog, &SettingsDialog::valuesUpdated, this, &HVACControl::updateFromSettings);
+    }
+    settingsDialog->setTemperatureUnit(controller.temperatureUnit());
+    settingsDialog->setLiveReadings(liveReadings());
     settingsDialog->show();
+    settingsDialog->raise();
+}
 
-    // Подключаем сигнал для обновления значений из настроек
-    connect(settingsDialog, &SettingsDialog::valuesUpdated, this, &HVACControl::updateFromSettings);
+void HVACControl::applyProfile(const hvac::SessionProfile &profile) {
+    profile.applySetpoints(zones);
+    // Через виджеты, чтобы списки и метки совпадали с состоянием контроллера
+    tempScaleCombo->setCurrentIndex(static_cast<int>(profile.temperatureUnit));
+    pressureScaleCombo->setCurrentIndex(static_cast<int>(profile.pressureUnit));
+    zoneSpinBox->setValue(static_cast<int>(std::min<hvac::ZoneStore::ZoneId>(profile.selectedZone, kZoneCount - 1)));
 }
 
-void HVACControl::toggleAC() {
-    acStatus = !acStatus;
-    toggleButton->setText(acStatus ? "Выключить кондиционер" : "Включить кондиционер");
+hvac::SessionProfile HVACControl::sessionProfile() const {
+    hvac::SessionProfile profile;
+    profile.width = static_cast<std::uint16_t>(width());
+    profile.height = static_cast<std::uint16_t>(height());
+    profile.theme = windowTheme;
+    profile.temperatureUnit = controller.temperatureUnit();
+    profile.pressureUnit = controller.pressureUnit();
+    profile.selectedZone = controller.zone();
+    profile.captureSetpoints(zones);
+    return profile;
 }
 
-void HVACControl::changeScaleTemperature(const QString &scale) {
-    if (scale == "Celsius") {
-        convertTemperature("°C");
-    } else if (scale == "Fahrenheit") {
-        convertTemperature("°F");
-    } else if (scale == "Kelvin") {
-        convertTemperature("K");
+void HVACControl::setRefreshRate(int hz) {
+    refreshTimer->setInterval(1000 / std::max(1, hz));
+}
+
+void HVACControl::startSensorSimulation(double samplesPerSecond) {
+    setSimulationSpeed(0); // Показания теперь задают датчики
+    sensorSimulator = std::make_unique<hvac::SensorSimulator>(ingestion, samplesPerSecond);
+    sensorSimulator->start();
+    if (settingsDialog != nullptr) {
+        settingsDialog->setLiveReadings(liveReadings());
     }
 }
 
-void HVACControl::convertTemperature(const QString &toScale) {
-    double originalTemp = temp;
-    if (unittemperature == "°C") {
-        if (toScale == "°F") {
-            temp = (originalTemp * 9.0 / 5.0) + 32;
-            unittemperature = "°F";
-        } else if (toScale == "K") {
-            temp = originalTemp + 273.15;
-            unittemperature = "K";
-        }
-    } else if (unittemperature == "°F") {
-        if (toScale == "°C") {
-            temp = (originalTemp - 32) * 5.0 / 9.0;
-            unittemperature = "°C";
-        } else if (toScale == "K") {
-            temp = (originalTemp - 32) * 5.0 / 9.0 + 273.15;
-            unittemperature = "K";
+void HVACControl::setSimulationSpeed(double speed) {
+    simulationSpeed = std::max(0.0, speed);
+    if (settingsDialog != nullptr) {
+        settingsDialog->setLiveReadings(liveReadings());
+    }
+}
+
+bool HVACControl::startTelemetry(const QString &path) {
+    telemetry = std::make_unique<hvac::TelemetryWriter>(path.toStdString());
+    if (!telemetry->isOpen()) {
+        telemetry.reset();
+        return false;
+    }
+    // Окно не удаляется при выходе, поэтому хвост журнала дописываем явно
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        if (telemetry) {
+            telemetry->close();
         }
-    } else if (unittemperature == "K") {
-        if (toScale == "°C") {
-            temp = originalTemp - 273.15;
-            unittemperature = "°C";
-        } else if (toScale == "°F") {
-            temp = (originalTemp - 273.15) * 9.0 / 5.0 + 32;
-            unittemperature = "°F";
+    });
+    return true;
+}
+
+bool HVACControl::replayTelemetry(const QString &path) {
+    hvac::TelemetryReader reader;
+    if (!reader.open(path.toStdString())) {
+        return false;
+    }
+    hvac::replayTelemetry(reader, zones);
+    selectZone(static_cast<int>(controller.zone())); // Обновляем кнопку, метки и график
+    return true;
+}
+
+bool HVACControl::startControlServer(const QString &address) {
+    controlServer = std::make_unique<hvac::ControlServer>();
+    bool isPort = false;
+    const int port = address.toInt(&isPort);
+    const bool listening = isPort ? port > 0 && port < 65536 && controlServer->listenTcp(static_cast<std::uint16_t>(port))
+                                  : controlServer->listenUnix(address.toStdString());
+    if (!listening) {
+        controlServer.reset();
+        return false;
+    }
+    controlServer->publish(zones);
+    return true;
+}
+
+hvac::ScheduleTime HVACControl::currentScheduleTime() {
+    const QDateTime now = QDateTime::currentDateTime();
+    return hvac::scheduleTimeFromUnix(now.toSecsSinceEpoch(), now.offsetFromUtc());
+}
+
+bool HVACControl::useSchedule(const QString &name) {
+    hvac::SetpointProgram program;
+    if (name == "office") {
+        // Будни 07:00–19:00 — комфорт, ночью и в выходные — снижение
+        program.points = {{hvac::kWeekdays, 7 * 3600, hvac::ScheduleMode::Comfort},
+                          {hvac::kWeekdays, 19 * 3600, hvac::ScheduleMode::Setback},
+                          {hvac::kWeekend, 0, hvac::ScheduleMode::Setback}};
+    } else {
+        return false;
+    }
+    const hvac::ScheduleEngine::ProgramId id = schedule.addProgram(program);
+    for (hvac::ZoneStore::ZoneId zone = 0; zone < zones.size(); ++zone) {
+        schedule.assignProgram(zone, id);
+    }
+    applySchedule(); // Уставки текущего режима сразу, не дожидаясь таймера
+    return true;
+}
+
+bool HVACControl::importSetpoints(const QString &path) {
+    hvac::SetpointImporter importer(zones.size());
+    hvac::SetpointBatch batch;
+    hvac::ImportReport report;
+    if (!importer.importFile(path.toStdString(), batch, report)) {
+        return false;
+    }
+    batch.applyTo(zones);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        overrideSchedule(batch.zones[i]);
+        if (telemetry) {
+            telemetry->logSetpoint(batch.zones[i], batch.temperature[i], batch.humidity[i]);
         }
     }
-    updateLabels(temp, humidity, pressure, unittemperature, unitpressure);
+    // Отклонённые строки не прерывают импорт: отчёт уходит в stderr, а не в модальные окна
+    std::fprintf(stderr, "setpoints: %zu of %zu rows applied, %zu rejected\n", report.accepted, report.rows,
+                 report.rejected);
+    for (const hvac::InputIssue &issue : report.issues) {
+        std::fprintf(stderr, "  row %zu: %s: %s\n", issue.row, hvac::inputFieldName(issue.field),
+                     hvac::inputErrorMessage(issue.error));
+    }
+    return true;
 }
 
-void HVACControl::changeScalePressure(const QString &scale) {
-    if (scale == "Pascals") {
-        convertPressure("Pa");
-    } else if (scale == "mmHg") {
-        convertPressure("mmHg");
+void HVACControl::overrideSchedule(hvac::ZoneStore::ZoneId zone) {
+    if (schedule.programOf(zone) == hvac::ScheduleEngine::kNoProgram) {
+        return;
     }
+    const hvac::ZoneSnapshot snapshot = zones.snapshot(zone);
+    schedule.overrideZone(zone, snapshot.setpointTemperature, snapshot.setpointHumidity);
 }
 
-void HVACControl::convertPressure(const QString &toScale) {
-    double originalPressure = pressure;
-    if (unitpressure == "Pa") {
-        if (toScale == "mmHg") {
-            pressure = originalPressure / 133.322;
-            unitpressure = "mmHg";
+void HVACControl::applySchedule() {
+    if (schedule.advance(currentScheduleTime(), scheduledSetpoints) == 0) {
+        return;
+    }
+    scheduledSetpoints.applyTo(zones);
+    HVAC_COUNT("scheduledSetpointsApplied", scheduledSetpoints.size());
+    if (telemetry) {
+        for (std::size_t i = 0; i < scheduledSetpoints.size(); ++i) {
+            telemetry->logSetpoint(scheduledSetpoints.zones[i], scheduledSetpoints.temperature[i],
+                                   scheduledSetpoints.humidity[i]);
         }
-    } else if (unitpressure == "mmHg") {
-        if (toScale == "Pa") {
-            pressure = originalPressure * 133.322;
-            unitpressure = "Pa";
+    }
+}
+
+void HVACControl::applyControlCommands() {
+    if (!controlServer) {
+        return;
+    }
+    // Все изменения за период применяются пакетом; окно перерисовывается один раз
+    bool selectedChanged = false;
+    controlServer->drain(controlCommands);
+    HVAC_COUNT("controlCommandsApplied", controlCommands.size());
+    for (const hvac::ControlCommand &command : controlCommands) {
+        hvac::applyControlCommand(zones, command);
+        if (command.opcode == hvac::ControlOpcode::SetSetpoint) {
+            overrideSchedule(command.zone);
         }
+        const hvac::ZoneSnapshot zone = zones.snapshot(command.zone);
+        if (command.opcode == hvac::ControlOpcode::SetLouver) {
+            louverChannel->setLouver(command.zone, zone.louverPan, zone.louverTilt);
+        }
+        if (telemetry) {
+            if (command.opcode == hvac::ControlOpcode::SetSetpoint) {
+                telemetry->logSetpoint(command.zone, zone.setpointTemperature, zone.setpointHumidity);
+            } else if (command.opcode == hvac::ControlOpcode::SetAC) {
+                telemetry->logACStatus(command.zone, zone.acOn);
+            } else if (command.opcode == hvac::ControlOpcode::SetLouver) {
+                telemetry->logLouver(command.zone, zone.louverPan, zone.louverTilt);
+            }
+        }
+        selectedChanged = selectedChanged || command.zone == controller.zone();
+    }
+    if (selectedChanged) {
+        // Обновляем кнопку, метки и слайдеры выбранной зоны, не очищая график
+        toggleButton->setText(controller.acStatus() ? "Выключить кондиционер" : "Включить кондиционер");
+        const hvac::ZoneSnapshot snapshot = zones.snapshot(controller.zone());
+        const QSignalBlocker panBlocker(airDirectionSlider);
+        const QSignalBlocker tiltBlocker(airDirectionSliderVertical);
+        airDirectionSlider->setValue(snapshot.louverPan);
+        airDirectionSliderVertical->setValue(snapshot.louverTilt);
+        airDirectionLabel->setText(QString("Текущее направление: %1° / %2°").arg(snapshot.louverPan).arg(snapshot.louverTilt));
+    }
+    controlServer->publish(zones);
+}
+
+void HVACControl::advanceSimulation() {
+    const double elapsedSeconds = simulationClock.restart() / 1000.0;
+    if (simulationSpeed <= 0) {
+        return;
+    }
+    if (simulation.advance(elapsedSeconds * simulationSpeed) > 0) {
+        updateLabels();
+    }
+}
+
+void HVACControl::applySensorBatch() {
+    const std::size_t drained = ingestion.drain(sensorBatch);
+    if (drained == 0) {
+        return;
+    }
+    HVAC_COUNT("sensorSamplesApplied", drained);
+    sensorBatch.applyTo(zones);
+
+    // Метки обновляются только при новых данных выбранной зоны
+    const auto &updatedZones = sensorBatch.zones;
+    if (std::find(updatedZones.begin(), updatedZones.end(), controller.zone()) != updatedZones.end()) {
+        updateLabels();
     }
-    updateLabels(temp, humidity, pressure, unittemperature, unitpressure);
 }
 
-void HVACControl::updateLabels(double temp, int humidity, float pressure, const QString &scaleT, const QString &scaleP) {
-    temperatureLabel->setText(QString("Температура: %1 %2").arg(temp, 0, 'f', 2).arg(scaleT));
-    humidityLabel->setText(QString("Влажность: %1 %").arg(humidity));
-    pressureLabel->setText(QString("Давление: %1 %2").arg(pressure, 0, 'f', 2).arg(scaleP));
+void HVACControl::toggleAC() {
+    HVAC_SCOPED_TIMER("toggleAC");
+    bool acStatus = controller.toggleAC();
+    if (telemetry) {
+        telemetry->logACStatus(controller.zone(), acStatus);
+    }
+    toggleButton->setText(acStatus ? "Выключить кондиционер" : "Включить кондиционер");
+}
+
+void HVACControl::changeScaleTemperature(int index) {
+    if (index < 0) {
+        return;
+    }
+    controller.setTemperatureUnit(static_cast<hvac::TemperatureUnit>(index));
+    if (settingsDialog != nullptr) {
+        settingsDialog->setTemperatureUnit(controller.temperatureUnit());
+    }
+    updateLabels();
+}
+
+void HVACControl::changeScalePressure(int index) {
+    if (index < 0) {
+        return;
+    }
+    controller.setPressureUnit(static_cast<hvac::PressureUnit>(index));
+    updateLabels();
+}
+
+void HVACControl::updateLabels() {
+    HVAC_SCOPED_TIMER("updateLabels");
+    labelRenderer->setReadings(controller.temperature(), controller.temperatureUnit(), controller.humidity(),
+                               controller.pressure(), controller.pressureUnit());
 }
 
 void HVACControl::updateFromSettings(float newTemp, int newHumidity, float newPressure) {
-    temp = newTemp;
-    humidity = newHumidity;
-    pressure = newPressure;
-    updateLabels(temp, humidity, pressure, unittemperature, unitpressure);
+    HVAC_SCOPED_TIMER("updateFromSettings");
+    // Введённые значения — уставки зоны; к ним ведёт модель помещения при включённом кондиционере
+    controller.setSetpoint(newTemp, newHumidity);
+    overrideSchedule(controller.zone());
+    if (telemetry) {
+        const hvac::ZoneSnapshot zone = zones.snapshot(controller.zone());
+        telemetry->logSetpoint(controller.zone(), zone.setpointTemperature, zone.setpointHumidity);
+    }
+    if (!liveReadings()) {
+        // Без модели и датчиков показания повторяют введённые значения
+        controller.update(newTemp, newHumidity, newPressure);
+    }
+    updateLabels();
+}
+
+void HVACControl::sampleTrend() {
+    const hvac::ZoneStore::ZoneId zone = controller.zone();
+    if (trendChart != nullptr) {
+        trendChart->addSample(zones.temperature(zone), zones.humidity(zone), zones.pressure(zone));
+    }
+
+    // Неизменившиеся показания журнал отбрасывает сам
+    if (telemetry) {
+        for (hvac::ZoneStore::ZoneId id = 0; id < zones.size(); ++id) {
+            telemetry->logReading(id, zones.temperature(id), zones.humidity(id), zones.pressure(id));
+        }
+    }
 }
 
-void HVACControl::changeAirDirection(int angle) {
-    airDirectionLabel->setText(QString("Текущее направление: %1°").arg(angle)); // Обновляем метку
-    qDebug() << "Изменено направление подачи воздуха на:" << angle << "градусов.";
+void HVACControl::selectZone(int zone) {
+    controller.selectZone(static_cast<hvac::ZoneStore::ZoneId>(zone));
+    if (trendChart != nullptr) {
+        trendChart->clear(); // История относится к ранее выбранной зоне
+    }
+    toggleButton->setText(controller.acStatus() ? "Выключить кондиционер" : "Включить кондиционер");
+    updateLabels();
+
+    // Слайдеры показывают жалюзи выбранной зоны; команду приводу при этом не шлём
+    const hvac::ZoneSnapshot snapshot = zones.snapshot(controller.zone());
+    const QSignalBlocker panBlocker(airDirectionSlider);
+    const QSignalBlocker tiltBlocker(airDirectionSliderVertical);
+    airDirectionSlider->setValue(snapshot.louverPan);
+    airDirectionSliderVertical->setValue(snapshot.louverTilt);
+    airDirectionLabel->setText(QString("Текущее направление: %1° / %2°").arg(snapshot.louverPan).arg(snapshot.louverTilt));
+}
+
+void HVACControl::changeAirDirectionPan(int angle) {
+    HVAC_SCOPED_TIMER("changeAirDirection");
+    const hvac::ZoneStore::ZoneId zone = controller.zone();
+    zones.setLouver(zone, static_cast<std::int16_t>(angle), zones.snapshot(zone).louverTilt);
+    louverChannel->setPan(zone, angle); // Частые тики сворачиваются в канале
+    updateAirDirection();
+}
+
+void HVACControl::changeAirDirectionTilt(int angle) {
+    HVAC_SCOPED_TIMER("changeAirDirection");
+    const hvac::ZoneStore::ZoneId zone = controller.zone();
+    zones.setLouver(zone, zones.snapshot(zone).louverPan, static_cast<std::int16_t>(angle));
+    louverChannel->setTilt(zone, angle);
+    updateAirDirection();
+}
+
+void HVACControl::updateAirDirection() {
+    const hvac::ZoneStore::ZoneId zone = controller.zone();
+    const hvac::ZoneSnapshot snapshot = zones.snapshot(zone);
+    airDirectionLabel->setText(QString("Текущее направление: %1° / %2°").arg(snapshot.louverPan).arg(snapshot.louverTilt));
+    if (telemetry) {
+        telemetry->logLouver(zone, snapshot.louverPan, snapshot.louverTilt);
+    }
 }
 
 int main(int argc, char *argv[]) {
+    QElapsedTimer startupClock; // Время до первого кадра отсчитывается от входа в main
+    startupClock.start();
     QApplication app(argc, argv);
 
-    ResolutionDialog resDialog;
-    QObject::connect(&resDialog, &ResolutionDialog::resolutionChosen, [&](int width, int height, QString theme) {
+    // Необязательные параметры: --refresh-hz=<Гц>, --simulate-sensors=<показаний в секунду>,
+    // --sim-speed=<ускорение модели помещений, 0 — выключить>,
+    // --telemetry=<файл журнала; новый сеанс дописывается в конец>,
+    // --replay=<файл журнала для восстановления состояния>,
+    // --restore-session (взять разрешение, тему и уставки из профиля прошлого сеанса),
+    // --profile=<файл профиля>, --startup-time (вывести время до первого кадра в stderr),
+    // --control=<путь к Unix-сокету или порт на 127.0.0.1> (протокол управления, см. hvac_ctl),
+    // --metrics=<файл или "-" для stderr> (задержки слотов окна каждые 10 с; JSON, если файл *.json),
+    // --schedule=office (недельная программа уставок; ручной ввод действует до следующего переключения),
+    // --import-setpoints=<файл CSV "зона,°C,%" или HVST> (отчёт об отклонённых строках в stderr)
+    int refreshHz = 0;
+    double simulatedSamplesPerSecond = 0;
+    double simulationSpeed = -1;
+    QString telemetryPath;
+    QString replayPath;
+    bool restoreSession = false;
+    bool reportStartupTime = false;
+    QString controlAddress;
+    QString metricsPath;
+    QString scheduleName;
+    QString setpointsPath;
+    QString profilePath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/session.hvp";
+    for (const QString &argument : app.arguments()) {
+        if (argument.startsWith("--refresh-hz=")) {
+            refreshHz = argument.section('=', 1).toInt();
+        } else if (argument.startsWith("--simulate-sensors=")) {
+            simulatedSamplesPerSecond = argument.section('=', 1).toDouble();
+        } else if (argument.startsWith("--sim-speed=")) {
+            simulationSpeed = argument.section('=', 1).toDouble();
+        } else if (argument.startsWith("--telemetry=")) {
+            telemetryPath = argument.section('=', 1);
+        } else if (argument.startsWith("--replay=")) {
+            replayPath = argument.section('=', 1);
+        } else if (argument == "--restore-session") {
+            restoreSession = true;
+        } else if (argument.startsWith("--profile=")) {
+            profilePath = argument.section('=', 1);
+        } else if (argument == "--startup-time") {
+            reportStartupTime = true;
+        } else if (argument.startsWith("--control=")) {
+            controlAddress = argument.section('=', 1);
+        } else if (argument.startsWith("--metrics=")) {
+            metricsPath = argument.section('=', 1);
+        } else if (argument.startsWith("--schedule=")) {
+            scheduleName = argument.section('=', 1);
+        } else if (argument.startsWith("--import-setpoints=")) {
+            setpointsPath = argument.section('=', 1);
+        }
+    }
+
+    auto launch = [&](int width, int height, hvac::Theme theme, const hvac::SessionProfile *profile) {
         HVACControl *window = new HVACControl(width, height, theme, nullptr);
+        if (profile != nullptr) {
+            window->applyProfile(*profile);
+        } else {
+            // Первый запуск: диалог настроек открывается, когда окно уже на экране
+            QObject::connect(window, &HVACControl::firstFramePainted, window, &HVACControl::showSettings,
+                             Qt::QueuedConnection);
+        }
+        if (reportStartupTime) {
+            QObject::connect(window, &HVACControl::firstFramePainted, window, [&startupClock]() {
+                std::fprintf(stderr, "time-to-first-frame: %lld ms\n", static_cast<long long>(startupClock.elapsed()));
+            });
+        }
+        if (refreshHz > 0) {
+            window->setRefreshRate(refreshHz);
+        }
+        if (simulationSpeed >= 0) {
+            window->setSimulationSpeed(simulationSpeed);
+        }
+        if (!replayPath.isEmpty() && !window->replayTelemetry(replayPath)) {
+            QMessageBox::warning(window, "Журнал", "Не удалось открыть журнал телеметрии.");
+        }
+        if (!telemetryPath.isEmpty() && !window->startTelemetry(telemetryPath)) {
+            QMessageBox::warning(window, "Журнал", "Не удалось создать журнал телеметрии.");
+        }
+        if (simulatedSamplesPerSecond > 0) {
+            window->startSensorSimulation(simulatedSamplesPerSecond);
+        }
+        if (!controlAddress.isEmpty() && !window->startControlServer(controlAddress)) {
+            QMessageBox::warning(window, "Управление", "Не удалось открыть сокет протокола управления.");
+        }
+        if (!scheduleName.isEmpty() && !window->useSchedule(scheduleName)) {
+            QMessageBox::warning(window, "Расписание", "Неизвестная программа расписания.");
+        }
+        if (!setpointsPath.isEmpty() && !window->importSetpoints(setpointsPath)) {
+            QMessageBox::warning(window, "Уставки", "Не удалось прочитать таблицу уставок.");
+        }
+        // Профиль пишется при каждом выходе, чтобы следующий запуск мог пропустить диалог
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, window, [window, &profilePath]() {
+            QDir().mkpath(QFileInfo(profilePath).absolutePath());
+            hvac::saveSessionProfile(profilePath.toStdString(), window->sessionProfile());
+        });
         window->show();
+    };
+
+    std::unique_ptr<hvac::MetricsDumper> metricsDumper;
+    if (!metricsPath.isEmpty()) {
+        metricsDumper = std::make_unique<hvac::MetricsDumper>(
+            metricsPath.toStdString(), metricsPath.endsWith(".json") ? hvac::MetricsFormat::Json : hvac::MetricsFormat::Text);
+    }
+
+    hvac::SessionProfile profile;
+    if (restoreSession && hvac::loadSessionProfile(profilePath.toStdString(), profile)) {
+        launch(profile.width, profile.height, profile.theme, &profile);
+        return app.exec();
+    }
+
+    ResolutionDialog resDialog;
+    QObject::connect(&resDialog, &ResolutionDialog::resolutionChosen, [&](int width, int height, QString theme) {
+        launch(width, height, themeFromName(theme), nullptr);
     });
 
     resDialog.exec(); // Ожидаем, пока пользователь выберет разрешение
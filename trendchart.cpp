@@ -0,0 +1,94 @@
+#include "trendchart.h"
+
+#include <QGraphicsPathItem>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QPainterPath>
+#include <QPen>
+#include <QTimer>
+
+#include <algorithm>
+
+TrendChart::TrendChart(QGraphicsView *view, QGraphicsScene *scene, std::size_t historyCapacity,
+                       QObject *parent)
+    : QObject(parent), view(view) {
+    history.reserve(SeriesCount);
+    for (int series = 0; series < SeriesCount; ++series) {
+        history.emplace_back(historyCapacity);
+    }
+
+    const QColor colors[SeriesCount] = {QColor(220, 80, 60), QColor(60, 130, 220), QColor(90, 170, 90)};
+    for (int series = 0; series < SeriesCount; ++series) {
+        items[series] = scene->addPath(QPainterPath(), QPen(colors[series], 0));
+    }
+
+    frameTimer = new QTimer(this);
+    frameTimer->setSingleShot(true);
+    frameTimer->setInterval(kFrameIntervalMs);
+    connect(frameTimer, &QTimer::timeout, this, &TrendChart::render);
+}
+
+void TrendChart::addSample(double temperature, double humidity, double pressure) {
+    const double values[SeriesCount] = {temperature, humidity, pressure};
+    for (int series = 0; series < SeriesCount; ++series) {
+        history[series].push(values[series]);
+        decimation[series].push(history[series]);
+    }
+    scheduleRender();
+}
+
+void TrendChart::clear() {
+    for (int series = 0; series < SeriesCount; ++series) {
+        history[series].clear();
+        decimation[series].reset(history[series], decimation[series].buckets());
+    }
+    scheduleRender();
+}
+
+void TrendChart::scheduleRender() {
+    if (!frameTimer->isActive()) {
+        frameTimer->start();
+    }
+}
+
+void TrendChart::render() {
+    const QSize size = view->viewport()->size();
+    const int pixelWidth = std::max(1, size.width());
+    const double bandHeight = std::max(1, size.height()) / static_cast<double>(SeriesCount);
+
+    // Буфер точек растёт только при расширении окна
+    points.resize(std::max<std::size_t>(points.size(), 2 * static_cast<std::size_t>(pixelWidth)));
+
+    for (int series = 0; series < SeriesCount; ++series) {
+        // Новая ширина меняет разбиение на корзины: один полный пересчёт истории
+        if (decimation[series].buckets() != static_cast<std::size_t>(pixelWidth)) {
+            decimation[series].reset(history[series], static_cast<std::size_t>(pixelWidth));
+        }
+        buildPath(static_cast<Series>(series), pixelWidth, series * bandHeight, bandHeight);
+    }
+    view->setSceneRect(0, 0, pixelWidth, size.height());
+}
+
+void TrendChart::buildPath(Series series, int pixelWidth, double top, double bandHeight) {
+    // setPath() разделяет данные пути с элементом, поэтому путь каждого кадра новый
+    QPainterPath path;
+    const hvac::HistoryRing &values = history[series];
+    double low = 0;
+    double high = 0;
+    const std::size_t count = decimation[series].points(points.data(), low, high);
+    if (count > 0) {
+        // Отступ 10% сверху и снизу полосы; плоский ряд рисуется посередине
+        const double range = high > low ? high - low : 1.0;
+        const double xScale = values.size() > 1 ? (pixelWidth - 1) / static_cast<double>(values.size() - 1) : 0.0;
+        const double yScale = bandHeight * 0.8 / range;
+        const double base = high > low ? top + bandHeight * 0.9 : top + bandHeight * 0.5;
+        auto toScene = [&](const hvac::TrendPoint &point) {
+            return QPointF(point.index * xScale, base - (point.value - low) * yScale);
+        };
+        path.moveTo(toScene(points[0]));
+        for (std::size_t i = 1; i < count; ++i) {
+            path.lineTo(toScene(points[i]));
+        }
+    }
+    items[series]->setPath(path);
+}
@@ -0,0 +1,60 @@
+#ifndef TRENDCHART_H
+#define TRENDCHART_H
+
+#include <QObject>
+
+#include <vector>
+
+#include "historyring.h"
+
+class QGraphicsPathItem;
+class QGraphicsScene;
+class QGraphicsView;
+class QTimer;
+
+/**
+ * @class TrendChart
+ * @brief Живой график температуры, влажности и давления в существующей QGraphicsScene.
+ *
+ * История хранится в кольцевых буферах фиксированной ёмкости; прореживание
+ * min/max до ширины области просмотра ведётся инкрементально при добавлении
+ * значений и пересчитывается целиком только при смене ширины или очистке.
+ * Кадр строит новый путь из готовых корзин (не больше двух точек на пиксель)
+ * и отдаёт его QGraphicsPathItem, созданному один раз на ряд.
+ * Ряды рисуются в трёх горизонтальных полосах, каждый в собственном масштабе.
+ */
+class TrendChart : public QObject {
+    Q_OBJECT
+
+public:
+    TrendChart(QGraphicsView *view, QGraphicsScene *scene, std::size_t historyCapacity,
+               QObject *parent = nullptr);
+
+    void addSample(double temperature, double humidity, double pressure); // Базовые единицы
+    void clear();
+
+private slots:
+    void render();
+
+private:
+    enum Series {
+        TemperatureSeries,
+        HumiditySeries,
+        PressureSeries,
+        SeriesCount
+    };
+
+    static constexpr int kFrameIntervalMs = 33; // Не чаще ~30 кадров в секунду
+
+    void scheduleRender();
+    void buildPath(Series series, int pixelWidth, double top, double bandHeight);
+
+    QGraphicsView *view;                         // Область просмотра (задаёт ширину в пикселях)
+    std::vector<hvac::HistoryRing> history;      // История по рядам
+    hvac::MinMaxBuckets decimation[SeriesCount]; // Корзины min/max по рядам
+    QGraphicsPathItem *items[SeriesCount];       // Элементы сцены, по одному на ряд
+    std::vector<hvac::TrendPoint> points;        // Буфер прореженных точек
+    QTimer *frameTimer;                          // Однократный таймер кадра
+};
+
+#endif // TRENDCHART_H